@@ -0,0 +1,158 @@
+/** This file is part of Cutexture.
+ 
+ Copyright (c) 2010 Markus Weiland, Kevin Lang
+
+ Portions of this code may be under copyright of authors listed in AUTHORS.
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+#include "InputManager.h"
+#include "SyntheticInputSource.h"
+#include "UiManager.h"
+
+#include <iostream>
+
+using namespace Cutexture;
+
+namespace
+{
+	/** Number of events per measurement unless given as first
+	 * command line argument. */
+	const int DEFAULT_EVENT_COUNT = 100000;
+
+	/** Size of the synthetic mouse area and the benchmark UI. */
+	const QSize BENCHMARK_AREA(1280, 720);
+
+	void printResult(const char *aStage, int aEventCount, int aElapsedMs)
+	{
+		const double seconds = qMax(aElapsedMs, 1) / 1000.0;
+		std::cout << aStage << ": " << aEventCount << " events in " << aElapsedMs << " ms, "
+				<< qRound(aEventCount / seconds) << " events/s, " << (aElapsedMs * 1000.0
+				/ aEventCount) << " us/event" << std::endl;
+	}
+
+	/** Queues aCount mouse movements which sweep across aSize. */
+	void injectMouseSweep(SyntheticInputSource *aSource, const QSize &aSize, int aCount)
+	{
+		for (int i = 0; i < aCount; ++i)
+		{
+			aSource->injectMouseMove(i % aSize.width(), (i / aSize.width()) % aSize.height());
+		}
+	}
+
+	/** Queues aCount key events (alternating press and release)
+	 * of a key which is neither a modifier nor a movement key. */
+	void injectKeyStrokes(SyntheticInputSource *aSource, int aCount)
+	{
+		for (int i = 0; i < aCount; ++i)
+		{
+			if (i % 2 == 0)
+			{
+				aSource->injectKeyPress(OIS::KC_F5);
+			}
+			else
+			{
+				aSource->injectKeyRelease(OIS::KC_F5);
+			}
+		}
+	}
+
+	/** Creates a small form with the kind of widgets a game UI
+	 * typically contains. */
+	QWidget* createBenchmarkWidget()
+	{
+		QWidget *widget = new QWidget();
+		QGridLayout *layout = new QGridLayout(widget);
+
+		for (int i = 0; i < 16; ++i)
+		{
+			layout->addWidget(new QPushButton(QString("Button %1").arg(i)), i / 4, i % 4);
+		}
+		layout->addWidget(new QLineEdit(), 4, 0, 1, 2);
+		layout->addWidget(new QSlider(Qt::Horizontal), 4, 2, 1, 2);
+
+		widget->resize(BENCHMARK_AREA);
+		return widget;
+	}
+
+	/** Measures OIS to Qt translation (capture) and signal
+	 * emission separately for a batch of aEventCount events.
+	 * @param aWithUi If true, the events are dispatched to a
+	 * UiManager showing a benchmark form. */
+	void runStage(const char *aName, bool aMouse, bool aWithUi, int aEventCount)
+	{
+		InputManager inputManager;
+		SyntheticInputSource *source = new SyntheticInputSource(BENCHMARK_AREA);
+		inputManager.initialize(source);
+
+		UiManager uiManager;
+		if (aWithUi)
+		{
+			uiManager.setActiveWidget(createBenchmarkWidget());
+			uiManager.setInputManager(&inputManager);
+			QCoreApplication::processEvents();
+		}
+
+		if (aMouse)
+		{
+			injectMouseSweep(source, BENCHMARK_AREA, aEventCount);
+		}
+		else
+		{
+			injectKeyStrokes(source, aEventCount);
+		}
+
+		QTime timer;
+		timer.start();
+		inputManager.updateInputState();
+		const int captureMs = timer.restart();
+		inputManager.emitInputEvents();
+		const int emitMs = timer.elapsed();
+
+		std::cout << aName << std::endl;
+		printResult("  translate (OIS -> Qt event)", aEventCount, captureMs);
+		printResult(aWithUi ? "  emit + UiManager dispatch" : "  emit (no receivers)", aEventCount,
+				emitMs);
+		printResult("  total", aEventCount, captureMs + emitMs);
+
+		QCoreApplication::processEvents();
+	}
+}
+
+/** Measures the throughput of the input pipeline: OIS events are
+ * injected through a SyntheticInputSource, translated by
+ * InputManager and, optionally, dispatched to a UiManager. */
+int main(int argc, char *argv[])
+{
+	QApplication app(argc, argv);
+
+	int eventCount = DEFAULT_EVENT_COUNT;
+	if (app.arguments().size() > 1)
+	{
+		eventCount = qMax(1, app.arguments().at(1).toInt());
+	}
+
+	runStage("Mouse moves, no receivers", true, false, eventCount);
+	runStage("Mouse moves, UiManager", true, true, eventCount);
+	runStage("Key events, no receivers", false, false, eventCount);
+	runStage("Key events, UiManager", false, true, eventCount);
+
+	return 0;
+}
@@ -0,0 +1,197 @@
+/** This file is part of Cutexture.
+ 
+ Copyright (c) 2010 Markus Weiland, Kevin Lang
+
+ Portions of this code may be under copyright of authors listed in AUTHORS.
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+#include "JobSystem.h"
+
+#include <iostream>
+
+using namespace Cutexture;
+
+namespace
+{
+	/** Number of graph runs per measurement unless given as first
+	 * command line argument. */
+	const int DEFAULT_RUN_COUNT = 100;
+
+	/** Iterations of the busy loop of each job unless given as
+	 * second command line argument. */
+	const int DEFAULT_JOB_COST = 20000;
+
+	/** Jobs per stage of the frame graph. */
+	const int STAGE_WIDTH = 64;
+
+	/** Stages of the frame graph; the jobs of a stage depend on
+	 * two neighbouring jobs of the previous stage. */
+	const int STAGE_COUNT = 4;
+
+	/** Stands in for the work of a subsystem, e.g. animating a
+	 * group of objects. */
+	class BusyJob: public Job
+	{
+	public:
+		BusyJob(int aCost) :
+			mCost(aCost), mResult(0)
+		{
+		}
+
+		void run()
+		{
+			quint32 value = mResult + 1;
+			for (int i = 0; i < mCost; ++i)
+			{
+				value = value * 1664525u + 1013904223u;
+			}
+			// keeps the compiler from removing the work
+			mResult = value;
+		}
+
+	private:
+		int mCost;
+		quint32 mResult;
+	};
+
+	/** Fills aGraph with jobs without dependencies. */
+	void buildIndependentGraph(JobGraph &aGraph, int aJobCost)
+	{
+		for (int i = 0; i < STAGE_WIDTH * STAGE_COUNT; ++i)
+		{
+			aGraph.addJob(new BusyJob(aJobCost));
+		}
+	}
+
+	/** Fills aGraph with STAGE_COUNT stages of STAGE_WIDTH jobs
+	 * each, the shape of a frame of a game: every stage works on
+	 * the results of the previous one.
+	 * @param aMainThreadJobs If true, every eighth job must run on
+	 * the main thread, like calls into Qt widgets or Ogre. */
+	void buildStagedGraph(JobGraph &aGraph, int aJobCost, bool aMainThreadJobs)
+	{
+		for (int stage = 0; stage < STAGE_COUNT; ++stage)
+		{
+			for (int i = 0; i < STAGE_WIDTH; ++i)
+			{
+				QList<int> dependencies;
+				if (stage > 0)
+				{
+					const int previousStage = (stage - 1) * STAGE_WIDTH;
+					dependencies << previousStage + i << previousStage + (i + 1) % STAGE_WIDTH;
+				}
+
+				const bool mainThread = aMainThreadJobs && i % 8 == 0;
+				aGraph.addJob(new BusyJob(aJobCost), dependencies, mainThread
+						? JobSystem::MainThread : JobSystem::AnyThread);
+			}
+		}
+	}
+
+	void buildFrameGraph(JobGraph &aGraph, int aJobCost)
+	{
+		buildStagedGraph(aGraph, aJobCost, false);
+	}
+
+	void buildMixedGraph(JobGraph &aGraph, int aJobCost)
+	{
+		buildStagedGraph(aGraph, aJobCost, true);
+	}
+
+	/** Runs aGraph aRunCount times with aThreadCount threads
+	 * including the main thread.
+	 * @return The average time per run in milliseconds. */
+	double measure(JobGraph &aGraph, int aThreadCount, int aRunCount, int &aSteals)
+	{
+		JobSystem jobSystem(aThreadCount - 1);
+
+		// let the workers start and touch the graph once
+		jobSystem.run(aGraph);
+		const int initialSteals = jobSystem.getStealCount();
+
+		QTime timer;
+		timer.start();
+		for (int run = 0; run < aRunCount; ++run)
+		{
+			jobSystem.run(aGraph);
+		}
+		const int elapsed = timer.elapsed();
+
+		aSteals = (jobSystem.getStealCount() - initialSteals) / aRunCount;
+		return double(elapsed) / aRunCount;
+	}
+
+	void measureScaling(const char *aName, void(*aBuildGraph)(JobGraph &, int), int aJobCost,
+			int aMaxThreadCount, int aRunCount)
+	{
+		JobGraph graph;
+		aBuildGraph(graph, aJobCost);
+
+		std::cout << std::endl << aName << " (" << graph.getJobCount() << " jobs):" << std::endl;
+
+		double singleThreadMs = 0;
+		for (int threadCount = 1; threadCount <= aMaxThreadCount; ++threadCount)
+		{
+			int steals = 0;
+			const double ms = measure(graph, threadCount, aRunCount, steals);
+			if (threadCount == 1)
+			{
+				singleThreadMs = ms;
+			}
+
+			const double speedup = (ms > 0) ? singleThreadMs / ms : 0;
+			std::cout << "  " << threadCount << " threads: " << ms << " ms/run, speedup "
+					<< speedup << ", efficiency " << int(100 * speedup / threadCount) << "%, "
+					<< steals << " steals/run" << std::endl;
+		}
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication app(argc, argv);
+
+	int runCount = DEFAULT_RUN_COUNT;
+	if (app.arguments().size() > 1)
+	{
+		runCount = qMax(1, app.arguments().at(1).toInt());
+	}
+
+	int jobCost = DEFAULT_JOB_COST;
+	if (app.arguments().size() > 2)
+	{
+		jobCost = qMax(1, app.arguments().at(2).toInt());
+	}
+
+	const int maxThreadCount = qMax(1, QThread::idealThreadCount());
+
+	std::cout << "Job system benchmark: 1 to " << maxThreadCount << " threads, " << runCount
+			<< " runs per measurement, " << jobCost << " iterations per job." << std::endl
+			<< "Threads include the main thread, which works on the graph while it waits."
+			<< std::endl;
+
+	measureScaling("Independent jobs", buildIndependentGraph, jobCost, maxThreadCount, runCount);
+	measureScaling("Frame graph", buildFrameGraph, jobCost, maxThreadCount, runCount);
+	measureScaling("Frame graph with main thread jobs", buildMixedGraph, jobCost, maxThreadCount,
+			runCount);
+
+	return 0;
+}
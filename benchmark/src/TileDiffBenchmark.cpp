@@ -0,0 +1,246 @@
+/** This file is part of Cutexture.
+ 
+ Copyright (c) 2010 Markus Weiland, Kevin Lang
+
+ Portions of this code may be under copyright of authors listed in AUTHORS.
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+#include "TileDiff.h"
+
+#include <cstring>
+#include <iostream>
+
+using namespace Cutexture;
+
+namespace
+{
+	/** Number of frames per measurement unless given as first
+	 * command line argument. */
+	const int DEFAULT_FRAME_COUNT = 200;
+
+	/** Size of the benchmark image; a 1080p UI in its power-of-two
+	 * texture would be 2048x2048, but only the view size is hashed
+	 * and uploaded. */
+	const QSize BENCHMARK_SIZE(1920, 1080);
+
+	const int TILE_SIZES[] = { 32, 64, 128 };
+
+	/** Percentage of tiles changed per frame. */
+	const int CHANGED_PERCENTAGES[] = { 0, 1, 5, 10, 25, 50, 75, 100 };
+
+	/** Copies aRect of aSource into the same place of aTarget. Stands
+	 * in for the upload: the driver copies the pixels into a staging
+	 * buffer at least once. */
+	void copyRect(const QImage &aSource, QImage &aTarget, const QRect &aRect)
+	{
+		const int rowBytes = aRect.width() * 4;
+		for (int y = aRect.top(); y <= aRect.bottom(); ++y)
+		{
+			std::memcpy(aTarget.scanLine(y) + aRect.left() * 4, aSource.constScanLine(y)
+					+ aRect.left() * 4, rowBytes);
+		}
+	}
+
+	/** Changes one pixel in each of the first aCount tiles (in
+	 * column-interleaved order so that changes are spread over the
+	 * image) so that each of them hashes differently than in the
+	 * previous frame. */
+	void touchTiles(QImage &aImage, int aTileSize, int aCount, int aFrame)
+	{
+		const int tilesX = (aImage.width() + aTileSize - 1) / aTileSize;
+		const int tilesY = (aImage.height() + aTileSize - 1) / aTileSize;
+
+		for (int i = 0; i < aCount; ++i)
+		{
+			const int tileX = i / tilesY;
+			const int tileY = i % tilesY;
+			assert(tileX < tilesX);
+
+			const int x = qMin(tileX * aTileSize + aFrame % aTileSize, aImage.width() - 1);
+			const int y = qMin(tileY * aTileSize, aImage.height() - 1);
+			aImage.setPixel(x, y, aImage.pixel(x, y) ^ 0x01010101);
+		}
+	}
+
+	/** Flips every bit of every pixel of a tile, one at a time,
+	 * and checks that TileDiff reports the tile as changed both
+	 * after the flip and after flipping it back.
+	 * @return The number of undetected changes. */
+	int verifyBitFlips()
+	{
+		const int tileSize = 64;
+		QImage image(tileSize, tileSize, QImage::Format_ARGB32);
+		for (int y = 0; y < image.height(); ++y)
+		{
+			for (int x = 0; x < image.width(); ++x)
+			{
+				image.setPixel(x, y, qRgba(x * 4, y * 4, x ^ y, 0xff));
+			}
+		}
+
+		TileDiff tileDiff(tileSize);
+		tileDiff.update(image);
+
+		int missed = 0;
+		for (int y = 0; y < image.height(); ++y)
+		{
+			for (int x = 0; x < image.width(); ++x)
+			{
+				for (int bit = 0; bit < 32; ++bit)
+				{
+					const QRgb pixel = image.pixel(x, y);
+
+					image.setPixel(x, y, pixel ^ (1u << bit));
+					missed += tileDiff.update(image).isEmpty() ? 1 : 0;
+
+					image.setPixel(x, y, pixel);
+					missed += tileDiff.update(image).isEmpty() ? 1 : 0;
+				}
+			}
+		}
+
+		// two changes of the same bit in one row, e.g. alpha 0xff -> 0x7f
+		image.setPixel(1, 0, image.pixel(1, 0) & 0x7fffffff);
+		image.setPixel(1, 1, image.pixel(1, 1) & 0x7fffffff);
+		missed += tileDiff.update(image).isEmpty() ? 1 : 0;
+
+		return missed;
+	}
+
+	/** @return The average time per frame in milliseconds. */
+	double perFrame(int aElapsedMs, int aFrameCount)
+	{
+		return double(aElapsedMs) / aFrameCount;
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication app(argc, argv);
+
+	int frameCount = DEFAULT_FRAME_COUNT;
+	if (app.arguments().size() > 1)
+	{
+		frameCount = qMax(1, app.arguments().at(1).toInt());
+	}
+
+	const int missedChanges = verifyBitFlips();
+	if (missedChanges > 0)
+	{
+		std::cerr << "TileDiff missed " << missedChanges << " single bit changes." << std::endl;
+		return 1;
+	}
+	std::cout << "TileDiff detected all single bit changes of a tile." << std::endl;
+
+	QImage image(BENCHMARK_SIZE, QImage::Format_ARGB32);
+	QImage staging(BENCHMARK_SIZE, QImage::Format_ARGB32);
+
+	// some non-uniform content
+	for (int y = 0; y < image.height(); ++y)
+	{
+		QRgb *row = reinterpret_cast<QRgb *> (image.scanLine(y));
+		for (int x = 0; x < image.width(); ++x)
+		{
+			row[x] = qRgba(x & 0xff, y & 0xff, (x ^ y) & 0xff, 0xc0);
+		}
+	}
+
+	std::cout << "Tile diff benchmark: " << BENCHMARK_SIZE.width() << "x"
+			<< BENCHMARK_SIZE.height() << ", " << frameCount << " frames per measurement."
+			<< std::endl << "Uploads are simulated by copying into a staging image; real "
+			"texture uploads cost more, which moves the break-even point up." << std::endl;
+
+	// baseline: upload the whole image every frame
+	QTime timer;
+	timer.start();
+	for (int frame = 0; frame < frameCount; ++frame)
+	{
+		copyRect(image, staging, image.rect());
+	}
+	const double fullUploadMs = perFrame(timer.elapsed(), frameCount);
+	std::cout << "Full upload: " << fullUploadMs << " ms/frame" << std::endl;
+
+	for (size_t t = 0; t < sizeof(TILE_SIZES) / sizeof(TILE_SIZES[0]); ++t)
+	{
+		const int tileSize = TILE_SIZES[t];
+		const int tileCount = ((image.width() + tileSize - 1) / tileSize) * ((image.height()
+				+ tileSize - 1) / tileSize);
+
+		std::cout << std::endl << "Tile size " << tileSize << " (" << tileCount << " tiles):"
+				<< std::endl;
+
+		int breakEvenPercentage = -1;
+
+		for (size_t c = 0; c < sizeof(CHANGED_PERCENTAGES) / sizeof(CHANGED_PERCENTAGES[0]); ++c)
+		{
+			const int changedTiles = tileCount * CHANGED_PERCENTAGES[c] / 100;
+
+			TileDiff tileDiff(tileSize);
+			tileDiff.update(image);
+
+			int hashMs = 0;
+			int uploadMs = 0;
+			int uploadedPixels = 0;
+
+			for (int frame = 0; frame < frameCount; ++frame)
+			{
+				touchTiles(image, tileSize, changedTiles, frame);
+
+				timer.start();
+				const QVector<QRect> changedRects = tileDiff.update(image);
+				hashMs += timer.elapsed();
+
+				timer.start();
+				foreach(const QRect &rect, changedRects)
+				{
+					copyRect(image, staging, rect);
+					uploadedPixels += rect.width() * rect.height();
+				}
+				uploadMs += timer.elapsed();
+			}
+
+			const double totalMs = perFrame(hashMs + uploadMs, frameCount);
+			std::cout << "  " << CHANGED_PERCENTAGES[c] << "% changed: hash "
+					<< perFrame(hashMs, frameCount) << " ms, upload "
+					<< perFrame(uploadMs, frameCount) << " ms, total " << totalMs
+					<< " ms/frame, " << (uploadedPixels / frameCount) << " pixels/frame"
+					<< std::endl;
+
+			if (breakEvenPercentage < 0 && totalMs >= fullUploadMs)
+			{
+				breakEvenPercentage = CHANGED_PERCENTAGES[c];
+			}
+		}
+
+		if (breakEvenPercentage < 0)
+		{
+			std::cout << "  Tile diffing is cheaper than a full upload at all measured change rates."
+					<< std::endl;
+		}
+		else
+		{
+			std::cout << "  Break-even at about " << breakEvenPercentage
+					<< "% changed tiles; above that, a full upload is cheaper." << std::endl;
+		}
+	}
+
+	return 0;
+}
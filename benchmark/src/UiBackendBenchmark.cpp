@@ -0,0 +1,217 @@
+/** This file is part of Cutexture.
+ 
+ Copyright (c) 2010 Markus Weiland, Kevin Lang
+
+ Portions of this code may be under copyright of authors listed in AUTHORS.
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+#include "UiManager.h"
+
+#include <iostream>
+
+using namespace Cutexture;
+
+namespace
+{
+	/** Number of frames and input events per measurement unless given
+	 * as second command line argument. */
+	const int DEFAULT_ITERATION_COUNT = 200;
+
+	const QSize BENCHMARK_SIZE(1280, 720);
+
+	/** Number of thread-safe items, e.g. the markers of a map,
+	 * put around the form to measure parallel rasterization. Half
+	 * of them are stacked below the form, half above it. */
+	const int OVERLAY_ITEM_COUNT = 400;
+
+	/** @return The average time per iteration in milliseconds. */
+	double perIteration(int aElapsedMs, int aIterationCount)
+	{
+		return double(aElapsedMs) / aIterationCount;
+	}
+
+	/** @return The form in aFileName or NULL if it cannot be
+	 * loaded. */
+	QWidget* loadForm(const QString &aFileName)
+	{
+		QFile file(aFileName);
+		if (!file.open(QFile::ReadOnly))
+		{
+			std::cerr << "Cannot open " << aFileName.toStdString() << std::endl;
+			return NULL;
+		}
+
+		QUiLoader loader;
+		QWidget *widget = loader.load(&file);
+		file.close();
+
+		if (!widget)
+		{
+			std::cerr << "Cannot load " << aFileName.toStdString() << std::endl;
+		}
+
+		return widget;
+	}
+
+	/** Loads the form in aFileName and measures rendering and input
+	 * delivery with aBackend. */
+	void measure(Enums::UiBackend aBackend, const QString &aFileName, int aIterationCount)
+	{
+		QWidget *widget = loadForm(aFileName);
+		if (!widget)
+		{
+			return;
+		}
+
+		UiManager uiManager(aBackend);
+		uiManager.setActiveWidget(widget);
+
+		QResizeEvent resizeEvent(BENCHMARK_SIZE, QSize());
+		uiManager.resizeUi(&resizeEvent);
+		uiManager.setViewSize(BENCHMARK_SIZE);
+		QApplication::processEvents();
+
+		QImage image(BENCHMARK_SIZE, QImage::Format_ARGB32);
+
+		// full repaints, which is what the texture upload path does
+		QTime timer;
+		timer.start();
+		for (int i = 0; i < aIterationCount; ++i)
+		{
+			uiManager.renderIntoImage(image);
+		}
+		const double renderMs = perIteration(timer.elapsed(), aIterationCount);
+
+		// sweep the mouse over the form, clicking at every position
+		timer.start();
+		for (int i = 0; i < aIterationCount; ++i)
+		{
+			const QPoint pos((i * 37) % BENCHMARK_SIZE.width(), (i * 23) % BENCHMARK_SIZE.height());
+
+			QMouseEvent moveEvent(QEvent::MouseMove, pos, pos, Qt::NoButton, Qt::NoButton,
+					Qt::NoModifier);
+			uiManager.mouseMoveEvent(&moveEvent);
+
+			QMouseEvent pressEvent(QEvent::MouseButtonPress, pos, pos, Qt::LeftButton,
+					Qt::LeftButton, Qt::NoModifier);
+			uiManager.mousePressEvent(&pressEvent);
+
+			QMouseEvent releaseEvent(QEvent::MouseButtonRelease, pos, pos, Qt::LeftButton,
+					Qt::NoButton, Qt::NoModifier);
+			uiManager.mouseReleaseEvent(&releaseEvent);
+
+			QKeyEvent keyPressEvent(QEvent::KeyPress, Qt::Key_A, Qt::NoModifier, "a");
+			uiManager.keyPressEvent(&keyPressEvent);
+
+			QKeyEvent keyReleaseEvent(QEvent::KeyRelease, Qt::Key_A, Qt::NoModifier, "a");
+			uiManager.keyReleaseEvent(&keyReleaseEvent);
+		}
+		QApplication::processEvents();
+		const double inputMs = perIteration(timer.elapsed(), aIterationCount);
+
+		std::cout << (aBackend == Enums::UiBackendGraphicsView ? "Graphics view" : "Direct widget")
+				<< ": render " << renderMs << " ms/frame, input " << inputMs
+				<< " ms per move/click/key sequence" << std::endl;
+	}
+
+	/** Loads the form in aFileName with the graphics view backend,
+	 * adds thread-safe items below and above it and compares
+	 * rendering on the calling thread with parallel
+	 * rasterization, which paints the form on the calling thread
+	 * and the items on the global thread pool. */
+	void measureParallel(const QString &aFileName, int aIterationCount)
+	{
+		QWidget *widget = loadForm(aFileName);
+		if (!widget)
+		{
+			return;
+		}
+
+		UiManager uiManager(Enums::UiBackendGraphicsView);
+		uiManager.setActiveWidget(widget);
+
+		QResizeEvent resizeEvent(BENCHMARK_SIZE, QSize());
+		uiManager.resizeUi(&resizeEvent);
+		uiManager.setViewSize(BENCHMARK_SIZE);
+
+		for (int i = 0; i < OVERLAY_ITEM_COUNT; ++i)
+		{
+			const qreal x = (i * 97) % BENCHMARK_SIZE.width();
+			const qreal y = (i * 61) % BENCHMARK_SIZE.height();
+
+			QGraphicsEllipseItem *item = uiManager.getScene()->addEllipse(x, y, 48, 48, QPen(
+					Qt::black), QBrush(QColor::fromHsv((i * 13) % 360, 200, 220, 160)));
+			item->setZValue((i % 2 == 0) ? -1 : 1);
+			UiManager::setThreadSafePainting(item);
+		}
+		QApplication::processEvents();
+
+		QImage image(BENCHMARK_SIZE, QImage::Format_ARGB32);
+
+		QTime timer;
+		timer.start();
+		for (int i = 0; i < aIterationCount; ++i)
+		{
+			uiManager.renderIntoImage(image);
+		}
+		const double serialMs = perIteration(timer.elapsed(), aIterationCount);
+
+		uiManager.setParallelRendering(true);
+
+		timer.start();
+		for (int i = 0; i < aIterationCount; ++i)
+		{
+			uiManager.renderIntoImage(image);
+		}
+		const double parallelMs = perIteration(timer.elapsed(), aIterationCount);
+
+		std::cout << "Graphics view with " << OVERLAY_ITEM_COUNT << " thread-safe items: render "
+				<< serialMs << " ms/frame, parallel " << parallelMs << " ms/frame in "
+				<< uiManager.getLastRenderBandCount() << " bands" << std::endl;
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	QApplication app(argc, argv);
+
+	QString fileName = "demo/ui/game.ui";
+	if (app.arguments().size() > 1)
+	{
+		fileName = app.arguments().at(1);
+	}
+
+	int iterationCount = DEFAULT_ITERATION_COUNT;
+	if (app.arguments().size() > 2)
+	{
+		iterationCount = qMax(1, app.arguments().at(2).toInt());
+	}
+
+	std::cout << "UI backend benchmark: " << fileName.toStdString() << " at "
+			<< BENCHMARK_SIZE.width() << "x" << BENCHMARK_SIZE.height() << ", "
+			<< iterationCount << " iterations per measurement." << std::endl;
+
+	measure(Enums::UiBackendGraphicsView, fileName, iterationCount);
+	measure(Enums::UiBackendDirectWidget, fileName, iterationCount);
+	measureParallel(fileName, iterationCount);
+
+	return 0;
+}
@@ -26,12 +26,128 @@
 #pragma once
 
 #include "Prerequisites.h"
+#include "Enums.h"
 
 namespace Cutexture
 {
+	static const QString SETTINGS_CATEGORY_MAIN_LOOP = "Main Loop";
+	
+	/** "Continuous" renders a frame in every main loop iteration, 
+	 * "On Demand" only renders when something has changed. */
+	static const QString SETTINGS_RENDER_MODE_KEY = "Render Mode";
+	static const QString SETTINGS_RENDER_MODE_CONTINUOUS_VAL = "Continuous";
+	static const QString SETTINGS_RENDER_MODE_ON_DEMAND_VAL = "On Demand";
+	static const QString SETTINGS_RENDER_MODE_VAL = SETTINGS_RENDER_MODE_CONTINUOUS_VAL;
+	
+	/** In on-demand mode, frames per second rendered even if 
+	 * nothing changed. 0 disables keep-alive frames. */
+	static const QString SETTINGS_KEEP_ALIVE_RATE_KEY = "Keep Alive Rate";
+	static const int SETTINGS_KEEP_ALIVE_RATE_VAL = 1;
+	
+	/** In on-demand mode, milliseconds to wait for new events 
+	 * before polling input and window events again. */
+	static const QString SETTINGS_IDLE_POLL_INTERVAL_KEY = "Idle Poll Interval";
+	static const int SETTINGS_IDLE_POLL_INTERVAL_VAL = 10;
+	
+	/** Main loop iterations per second while the render window 
+	 * is inactive, minimized or obscured. 0 disables throttling. */
+	static const QString SETTINGS_BACKGROUND_TICK_RATE_KEY = "Background Tick Rate";
+	static const int SETTINGS_BACKGROUND_TICK_RATE_VAL = 10;
+	
+	/** If true, the UI texture and Qt's pixmap cache are released 
+	 * while the render window is minimized or obscured. */
+	static const QString SETTINGS_RELEASE_HIDDEN_UI_KEY = "Release Hidden UI Resources";
+	static const bool SETTINGS_RELEASE_HIDDEN_UI_VAL = false;
+	
+	/** Game logic steps per second. The logic always advances by 
+	 * the same time step, independent of the frame rate. */
+	static const QString SETTINGS_SIMULATION_RATE_KEY = "Simulation Rate";
+	static const int SETTINGS_SIMULATION_RATE_VAL = 60;
+	
+	/** Maximum game logic steps per frame. If a frame takes 
+	 * longer than this many steps, the game slows down instead of 
+	 * falling further behind with every frame. */
+	static const QString SETTINGS_MAX_SIMULATION_STEPS_KEY = "Max Simulation Steps";
+	static const int SETTINGS_MAX_SIMULATION_STEPS_VAL = 5;
+	
+	/** Threads which run the jobs of each frame next to the main 
+	 * thread. Negative uses all cores but one. @see JobSystem */
+	static const QString SETTINGS_WORKER_THREADS_KEY = "Worker Threads";
+	static const int SETTINGS_WORKER_THREADS_VAL = -1;
+	
+	static const QString SETTINGS_CATEGORY_USER_INTERFACE = "User Interface";
+	
+	/** If true, only the tiles of the UI texture whose contents 
+	 * really changed are uploaded. @see UiManager::setTileDiffing() */
+	static const QString SETTINGS_TILE_DIFFING_KEY = "Tile Diffing";
+	static const bool SETTINGS_TILE_DIFFING_VAL = false;
+	
+	/** Edge length in pixels of the tiles compared by tile diffing. */
+	static const QString SETTINGS_TILE_SIZE_KEY = "Tile Size";
+	static const int SETTINGS_TILE_SIZE_VAL = 64;
+	
+	/** Scale from layout to texture pixels, e.g. 0.5 to rasterize 
+	 * and upload a quarter of the pixels. @see UiManager::setRenderScale() */
+	static const QString SETTINGS_RENDER_SCALE_KEY = "Render Scale";
+	static const double SETTINGS_RENDER_SCALE_VAL = 1.0;
+	
+	/** Resolution at which the UI is laid out, as "<width>x<height>"; 
+	 * empty to lay out at window size. @see UiManager::setVirtualResolution() */
+	static const QString SETTINGS_VIRTUAL_RESOLUTION_KEY = "Virtual Resolution";
+	static const QString SETTINGS_VIRTUAL_RESOLUTION_VAL = "";
+	
+	/** Pixel format of the UI texture. @see Enums::TextureFormat */
+	static const QString SETTINGS_TEXTURE_FORMAT_KEY = "Texture Format";
+	static const QString SETTINGS_TEXTURE_FORMAT_ARGB8888_VAL = "ARGB8888";
+	static const QString SETTINGS_TEXTURE_FORMAT_ARGB4444_VAL = "ARGB4444";
+	static const QString SETTINGS_TEXTURE_FORMAT_ARGB1555_VAL = "ARGB1555";
+	static const QString SETTINGS_TEXTURE_FORMAT_ALPHA8_VAL = "Alpha8";
+	static const QString SETTINGS_TEXTURE_FORMAT_VAL = SETTINGS_TEXTURE_FORMAT_ARGB8888_VAL;
+	
+	/** Colour of the UI with the Alpha8 texture format, e.g. "#80ff80". */
+	static const QString SETTINGS_TINT_COLOUR_KEY = "Tint Colour";
+	static const QString SETTINGS_TINT_COLOUR_VAL = "#ffffff";
+	
+	/** If true, the UI is block-compressed once it stopped changing. 
+	 * @see UiManager::setStaticUi() */
+	static const QString SETTINGS_STATIC_UI_KEY = "Static UI";
+	static const bool SETTINGS_STATIC_UI_VAL = false;
+	
+	/** If true, the mouse cursor is drawn on its own overlay quad 
+	 * instead of by the system. @see CursorLayer */
+	static const QString SETTINGS_CURSOR_LAYER_KEY = "Cursor Layer";
+	static const bool SETTINGS_CURSOR_LAYER_VAL = true;
+	
+	/** If true, the UI texture is updated during the frame, right 
+	 * before the overlay is drawn. @see UiManager::setLateLatching() */
+	static const QString SETTINGS_LATE_LATCHING_KEY = "Late Latching";
+	static const bool SETTINGS_LATE_LATCHING_VAL = false;
+	
+	/** If true, Qt's animations advance once per frame instead 
+	 * of on Qt's timer. @see UiManager::setFrameClock() */
+	static const QString SETTINGS_FRAME_CLOCK_KEY = "Frame Clock";
+	static const bool SETTINGS_FRAME_CLOCK_VAL = true;
+	
+	/** Maximum UI repaints per second; 0 repaints whenever the UI 
+	 * changed. @see UiManager::setMaxRepaintRate() */
+	static const QString SETTINGS_MAX_REPAINT_RATE_KEY = "Max Repaint Rate";
+	static const int SETTINGS_MAX_REPAINT_RATE_VAL = 0;
+	
+	/** If true, items marked as thread-safe are rasterized on 
+	 * worker threads. @see UiManager::setParallelRendering() */
+	static const QString SETTINGS_PARALLEL_RENDERING_KEY = "Parallel Rendering";
+	static const bool SETTINGS_PARALLEL_RENDERING_VAL = false;
+	
+	/** If true, the UI runs in the ui-helper process next to the 
+	 * executable. @see Enums::UiBackendRemoteProcess */
+	static const QString SETTINGS_REMOTE_UI_KEY = "Remote UI";
+	static const bool SETTINGS_REMOTE_UI_VAL = false;
+	
 	/** Responsible for setting up and shutting down all game subsystems. */
-	class Core: public Ogre::Singleton<Core>
+	class Core: public QObject, public Ogre::Singleton<Core>
 	{
+	Q_OBJECT
+
 	public:
 		Core();
 		virtual ~Core();
@@ -48,9 +164,65 @@ namespace Cutexture
 			return mFrameUpdateRate;
 		}
 		
+		/** Records all input events to aFileName while running. 
+		 * Must be called before go(). */
+		void setInputRecordingFile(const QString &aFileName);
+		
+		/** Replays the input recording aFileName instead of 
+		 * reading the input devices. Must be called before go().
+		 * @param aRealTime If false, one recorded frame is replayed 
+		 * per main loop iteration and the recorded frame durations 
+		 * are used as frame update rate, which makes runs 
+		 * deterministic. */
+		void setInputReplayFile(const QString &aFileName, bool aRealTime);
+		
+		/** Marks the next frame as changed so that it is rendered 
+		 * in on-demand render mode. Call after modifying the scene 
+		 * outside of Game::applyGameLogic(). */
+		inline void invalidateFrame()
+		{
+			mFrameInvalidated = true;
+		}
+		
+		/** Ends the main loop after aFrameLimit frames. 0 means 
+		 * no limit. */
+		inline void setFrameLimit(unsigned int aFrameLimit)
+		{
+			mFrameLimit = aFrameLimit;
+		}
+		
 	protected:
 		
+	private slots:
+		/** Steps of the startup pipeline run by go(). Steps 
+		 * marked as such run on a worker thread. */
+		void setupSettings();
+		/** Worker thread. Warms the file system cache for the 
+		 * resource locations Ogre is about to index. */
+		void prefetchResources();
+		/** Worker thread. Reads the .ui files into memory. */
+		void readUiForms();
+		void setupOgre();
+		void setupInput();
+		void setupUserInterface();
+		void loadUserInterface();
+		void setupScene();
+
+		/** Updates the loading screen. @see ResourceLoader */
+		void showLoadingProgress(int aLoaded, int aTotal, const QString &aStatus);
+		/** Replaces the loading screen with the game screen. */
+		void showGameScreen();
+
 	private:
+		/** Jobs of mFrameJobs, run once per frame. Jobs marked as 
+		 * such may run on a worker thread; the others call Qt 
+		 * widgets or Ogre and stay on the main thread. */
+		void loadResources();
+		void updateUserInterface();
+		/** Worker thread. Advances the game logic by the fixed 
+		 * steps due in this frame. */
+		void simulate();
+
 		bool mEndCoreLoop;
 
 		// Owner of the following singletons
@@ -58,6 +230,14 @@ namespace Cutexture
 		Game *mGame;
 		InputManager* mInputManager; // Handle mouse and keyboard input
 		Settings* mSettings; // Store and retrieve application settings
+		ScreenRegistry *mScreens; // UI screens of the game
+		ResourcePack *mUiPack; // Forms of mScreens, if packed
+		ResourceLoader *mResourceLoader; // Loads Ogre resources while the main loop runs
+
+		/** Widgets of the loading screen. Null once it is replaced 
+		 * by the game screen, which destroys them. */
+		QProgressBar *mLoadingBar;
+		QLabel *mLoadingStatus;
 
 		/** Used to measure the time delta between two 
 		 * iterations of the entire main loop. The time is 
@@ -74,6 +254,113 @@ namespace Cutexture
 		 * rendered. */
 		Ogre::Real mFrameUpdateRate;
 
-		QWidget* loadUiFile(const QString &aUiFile, QWidget *aParent = 0);
+		/** File to record input events to. Empty if not recording. */
+		QString mInputRecordingFile;
+		
+		/** Input recording to replay. Empty if not replaying. */
+		QString mInputReplayFile;
+		bool mInputReplayRealTime;
+		
+		/** Source of replayed input events. Owned by mInputManager. */
+		ReplayInputSource *mReplaySource;
+		
+		/** Maximum number of frames to run; 0 for no limit. */
+		unsigned int mFrameLimit;
+		
+		/** If true, frames are only rendered if something changed 
+		 * or a keep-alive frame is due. */
+		bool mOnDemandRendering;
+		
+		/** Set by invalidateFrame(); reset when a frame is rendered. */
+		bool mFrameInvalidated;
+		
+		/** Maximum time between two rendered frames in on-demand 
+		 * mode; 0 if there is no maximum. */
+		int mKeepAliveInterval;
+		
+		/** Time to sleep in on-demand mode if nothing changed. */
+		int mIdlePollInterval;
+		
+		/** Minimum duration of a main loop iteration while the 
+		 * window is in the background; 0 for no minimum. */
+		int mBackgroundTickInterval;
+		
+		/** @see SETTINGS_RELEASE_HIDDEN_UI_KEY */
+		bool mReleaseHiddenUiResources;
+		
+		/** Duration in seconds of one game logic step. 
+		 * @see SETTINGS_SIMULATION_RATE_KEY */
+		Ogre::Real mSimulationStep;
+		
+		/** @see SETTINGS_MAX_SIMULATION_STEPS_KEY */
+		int mMaxSimulationSteps;
+		
+		/** Frame time in seconds not yet consumed by game logic 
+		 * steps; always less than mSimulationStep after a frame. */
+		Ogre::Real mSimulationAccumulator;
+		
+		/** @see SETTINGS_WORKER_THREADS_KEY */
+		int mWorkerThreads;
+		
+		JobSystem *mJobSystem;
+		
+		/** Work of each frame between input handling and 
+		 * rendering. */
+		JobGraph *mFrameJobs;
+		
+		/** Set by the jobs of mFrameJobs if the frame needs to be 
+		 * rendered. Only written by main thread jobs. */
+		bool mFrameDirty;
+		
+		/** @see SETTINGS_TILE_DIFFING_KEY */
+		bool mUiTileDiffing;
+		int mUiTileSize;
+		
+		/** @see SETTINGS_RENDER_SCALE_KEY */
+		qreal mUiRenderScale;
+		
+		/** @see SETTINGS_VIRTUAL_RESOLUTION_KEY */
+		QSize mUiVirtualResolution;
+		
+		/** @see SETTINGS_TEXTURE_FORMAT_KEY */
+		Enums::TextureFormat mUiTextureFormat;
+		
+		/** @see SETTINGS_TINT_COLOUR_KEY */
+		QColor mUiTintColour;
+		
+		/** @see SETTINGS_STATIC_UI_KEY */
+		bool mUiStatic;
+		
+		/** @see SETTINGS_CURSOR_LAYER_KEY */
+		bool mUiCursorLayer;
+		
+		/** @see SETTINGS_LATE_LATCHING_KEY */
+		bool mUiLateLatching;
+		
+		/** @see SETTINGS_FRAME_CLOCK_KEY */
+		bool mUiFrameClock;
+		
+		/** @see SETTINGS_MAX_REPAINT_RATE_KEY */
+		int mUiMaxRepaintRate;
+		
+		/** @see SETTINGS_PARALLEL_RENDERING_KEY */
+		bool mUiParallelRendering;
+		
+		/** @see SETTINGS_REMOTE_UI_KEY */
+		bool mUiRemote;
+		
+		/** Time since the last rendered frame. */
+		QTime mRenderTime;
+		
+		/** Time since go() was called; invalid once the first 
+		 * frame is rendered. */
+		QTime mStartupTime;
+		
+		/** Contents of game.ui, read by readUiForms(). */
+		QByteArray mGameForm;
+		
+		/** Registers the default values of the main loop and user 
+		 * interface settings and reads the current values. */
+		void loadSettings();
 	};
 }
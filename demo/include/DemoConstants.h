@@ -39,6 +39,13 @@ namespace Cutexture
 		
 		static const QString SETTINGS_FILENAME = "CutextureSettings.ini";
 		
+		/** Used instead of the loose .ui files if it exists. */
+		static const QString UI_RESOURCE_PACK = "ui.pak";
+		
+		/** Milliseconds per main loop iteration spent on loading 
+		 * resources while the loading screen is shown. */
+		static const int LOADING_FRAME_BUDGET = 10;
+		
 		static const Ogre::Real MOVEMENT_RATE_PER_SECOND = 10.0; // 10 meters per second.
 	}
 }
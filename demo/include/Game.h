@@ -40,7 +40,20 @@ namespace Cutexture
 
 		void setInputManager(InputManager *aInputManager);
 		
-		void applyGameLogic();
+		/** Samples the input of the current frame. Call once per 
+		 * frame before the game logic steps. */
+		void collectInput();
+
+		/** Advances the game logic by one fixed time step. 
+		 * @param aTimeStep Duration of the step in seconds. */
+		void applyGameLogic(Ogre::Real aTimeStep);
+
+		/** Moves the camera between its states after the last two 
+		 * game logic steps.
+		 * @param aAlpha 0 for the state before the last step, 1 
+		 * for the state after it.
+		 * @return True if the camera moved. */
+		bool interpolate(Ogre::Real aAlpha);
 
 	public slots:
 		/** Performs a shutdown of the game logic and then triggers 
@@ -52,5 +65,17 @@ namespace Cutexture
 		
 	private:
 		InputManager *mInputManager;
+
+		/** Mouse movement of the frames since the last game logic 
+		 * step while looking around. */
+		QPoint mPendingMouseDelta;
+
+		/** Camera state after the last game logic step. */
+		Ogre::Vector3 mCameraPosition;
+		Ogre::Quaternion mCameraOrientation;
+
+		/** Camera state before the last game logic step. */
+		Ogre::Vector3 mPreviousCameraPosition;
+		Ogre::Quaternion mPreviousCameraOrientation;
 	};
 }
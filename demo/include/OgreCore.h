@@ -35,6 +35,9 @@ namespace Cutexture
 	 * in Ogre. */
 	static const Ogre::String UI_TEXTURE_NAME = "UiTexture";
 
+	/** Name of the texture and material of the cursor layer. */
+	static const Ogre::String CURSOR_TEXTURE_NAME = "CursorTexture";
+
 	static const QString SETTINGS_CATEGORY_RENDERER_ENGINE = "Renderer Engine";
 	static const QString SETTINGS_CATEGORY_RENDERER_PARAMS = "Renderer Parameters";
 	
@@ -79,26 +82,63 @@ namespace Cutexture
 	
 	/** Responsible for setting up and shutting down the OGRE rendering 
 	 * engine. */
-	class OgreCore: public Ogre::Singleton<OgreCore>
+	class OgreCore: public Ogre::Singleton<OgreCore>, public Ogre::WindowEventListener
 	{
 	public:
 		OgreCore();
 		virtual ~OgreCore();
 
-		bool setupOgre();
+		/** @param aUiBackend Backend of the UiManager. */
+		bool setupOgre(Enums::UiBackend aUiBackend = Enums::UiBackendGraphicsView);
+
+		/** Reads the resource locations listed in resources.cfg in 
+		 * aResourcePath, so that indexing them in setupOgre() hits 
+		 * the file system cache. Does not touch Ogre's singletons 
+		 * and may run on any thread, e.g. while setupOgre() creates 
+		 * the render window. */
+		static void prefetchResources(const QString &aResourcePath);
 
 		/** Creates the scene elements needed for the user interface and 
 		 * then creates the user interface widgets. */
 		void setupUserInterface();
 
+		/** Creates a CursorLayer which draws the mouse cursor above 
+		 * the user interface. Call after setupUserInterface(). */
+		void setupCursorLayer();
+
+		/** Moves the cursor layer to the current mouse position of 
+		 * aInputManager and shows the cursor of the widget under 
+		 * the mouse. Does nothing without a cursor layer. */
+		void updateCursor(InputManager *aInputManager);
+
+		/** Fits the user interface overlay to the current UI 
+		 * content. Call after the UI texture was updated. */
+		void updateUserInterfaceBounds();
+
 		/** Tell Ogre to render one frame. */
 		void renderFrame();
 
 		Ogre::RenderWindow* const getOgreRenderWindow() const;
 
 		/** Checks if the Ogre render window was resized and notifies the 
-		 * UiManager if needed. */
-		void processWindowEvents(InputManager *aInputManager);
+		 * UiManager if needed.
+		 * @return True if the window was resized, moved or 
+		 * changed focus since the last call. */
+		bool processWindowEvents(InputManager *aInputManager);
+
+		/** @return True if the render window is active, i.e. 
+		 * focused or, depending on the platform, at least not 
+		 * obscured. */
+		inline bool isWindowActive() const { return mWindowActive; }
+		
+		/** @return False if the render window is minimized or 
+		 * fully obscured. */
+		inline bool isWindowVisible() const { return mWindowVisible; }
+		
+		/** @see Ogre::WindowEventListener */
+		void windowMoved(Ogre::RenderWindow *aRenderWindow);
+		void windowResized(Ogre::RenderWindow *aRenderWindow);
+		void windowFocusChange(Ogre::RenderWindow *aRenderWindow);
 		
 		inline UiManager* getUiManager() const { return mUiManager; }
 
@@ -110,6 +150,9 @@ namespace Cutexture
 		/** Manager for the User Interface. */
 		UiManager* mUiManager;
 
+		/** Draws the mouse cursor. Null if not set up. Owned by us. */
+		CursorLayer *mCursorLayer;
+
 		/** Pointer to Ogre's render window Ogre::RenderWindow. Owned by Ogre. */
 		Ogre::RenderWindow *mOgreRenderWindow;
 
@@ -117,6 +160,10 @@ namespace Cutexture
 		 * object instances (Ex: sceneNode->createChildNode()). */
 		Ogre::Root* mOgreRoot;
 
+		/** Lets resources.cfg list resource packs. Owned by us, 
+		 * deleted after mOgreRoot. */
+		PackArchiveFactory *mPackArchiveFactory;
+
 		/** SceneManager for the Ogre scene. Owned by us. */
 		SceneManager *mSceneManager;
 
@@ -128,6 +175,14 @@ namespace Cutexture
 		/** Height of Ogre's renderer window at the last query. */
 		unsigned int mRenderWindowHeight;
 
+		/** Set if a window event was received since the last call 
+		 * to processWindowEvents(). */
+		bool mWindowEventsPending;
+		
+		/** Window state as of the last focus change event. */
+		bool mWindowActive;
+		bool mWindowVisible;
+
 		/** Load resources (e.g. meshes, sounds, xml files).
 		 @param resourcePath Path to directory where resources.cfg is located.
 		 */
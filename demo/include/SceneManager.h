@@ -38,9 +38,22 @@ namespace Cutexture
 		void setupDefaultScene();
 
 		/** Sets up the scene geometry, materials and textures required 
-		 * for rendering the user interface. */
-		void setupUserInterfaceElements();
+		 * for rendering the user interface.
+		 * @param aTextureFormat Pixel format of the UI texture. */
+		void setupUserInterfaceElements(Ogre::PixelFormat aTextureFormat);
+
+		/** Shrinks the user interface overlay to the part of the 
+		 * window that contains UI content, so that no fill rate is 
+		 * spent on blending fully transparent pixels. Hides the 
+		 * overlay if aBounds is empty.
+		 * @param aBounds Content bounds in window coordinates.
+		 * @param aWindowSize Size of the render window.
+		 * @see UiManager::getContentBounds() */
+		void setUserInterfaceBounds(const QRect &aBounds, const QSize &aWindowSize);
 
 	protected:
+		/** Screen-space rectangle displaying the UI texture. Owned 
+		 * by its scene node. */
+		Ogre::Rectangle2D *mUserInterfaceScreen;
 	};
 }
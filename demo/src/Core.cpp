@@ -28,9 +28,16 @@
 #include "OgreCore.h"
 #include "SleepThread.h"
 #include "InputManager.h"
+#include "ReplayInputSource.h"
 #include "SceneManager.h"
 #include "Exception.h"
 #include "Settings.h"
+#include "DemoConstants.h"
+#include "ScreenRegistry.h"
+#include "ResourcePack.h"
+#include "StartupPipeline.h"
+#include "ResourceLoader.h"
+#include "JobSystem.h"
 #include <iostream>
 
 #include <QWebView>
@@ -43,15 +50,40 @@ namespace Cutexture
 {
 	Core::Core() :
 		mEndCoreLoop(false), mOgreCore(NULL), mGame(NULL), mInputManager(NULL), mSettings(NULL),
-				mFrameUpdateRate(0)
+				mScreens(NULL), mUiPack(NULL), mResourceLoader(NULL), mLoadingBar(NULL),
+				mLoadingStatus(NULL), mFrameUpdateRate(0), mInputReplayRealTime(true),
+				mReplaySource(NULL), mFrameLimit(0), mOnDemandRendering(false),
+				mFrameInvalidated(true), mKeepAliveInterval(0), mIdlePollInterval(1),
+				mBackgroundTickInterval(0), mReleaseHiddenUiResources(false),
+				mSimulationStep(Ogre::Real(1) / SETTINGS_SIMULATION_RATE_VAL),
+				mMaxSimulationSteps(SETTINGS_MAX_SIMULATION_STEPS_VAL), mSimulationAccumulator(0),
+				mWorkerThreads(SETTINGS_WORKER_THREADS_VAL), mJobSystem(NULL), mFrameJobs(NULL),
+				mFrameDirty(false),
+				mUiTileDiffing(false), mUiTileSize(SETTINGS_TILE_SIZE_VAL), mUiRenderScale(1),
+				mUiTextureFormat(Enums::TextureFormatARGB8888), mUiStatic(false),
+				mUiCursorLayer(SETTINGS_CURSOR_LAYER_VAL),
+				mUiLateLatching(SETTINGS_LATE_LATCHING_VAL), mUiFrameClock(SETTINGS_FRAME_CLOCK_VAL),
+				mUiMaxRepaintRate(SETTINGS_MAX_REPAINT_RATE_VAL),
+				mUiParallelRendering(SETTINGS_PARALLEL_RENDERING_VAL), mUiRemote(SETTINGS_REMOTE_UI_VAL)
 	{
 		
 	}
 	
 	Core::~Core()
 	{
+		// the jobs use everything below
+		delete mFrameJobs;
+		delete mJobSystem;
+		
 		delete mGame;
+		
+		// holds Ogre resources
+		delete mResourceLoader;
+		
+		// the screens are widgets of the UiManager
+		delete mScreens;
 		delete mOgreCore;
+		delete mUiPack;
 		
 		
 		// The input manager should be deleted last in case events are still being fired.
@@ -62,46 +94,51 @@ namespace Cutexture
 	
 	void Core::go()
 	{
-		mSettings = new Settings();
-		mInputManager = new InputManager();
-		
-		mOgreCore = new OgreCore();
-		bool setupResult = mOgreCore->setupOgre();
-		
-		if (!setupResult)
-		{
-			EXCEPTION("Failed to setup OgreCore.", "Core::go()");
-		}
-
-		mInputManager->initialize(mOgreCore->getOgreRenderWindow());
+		mStartupTime.start();
 		
-		mOgreCore->setupUserInterface();
-		
-		QWidget *ui = loadUiFile("game.ui");
-		ui->setAttribute(Qt::WA_TranslucentBackground);
+		// independent steps overlap, e.g. reading files while Ogre creates the window
+		StartupPipeline startup;
+		startup.addStep("settings", this, "setupSettings");
+		startup.addStep("resource prefetch", this, "prefetchResources", QStringList(), true);
+		startup.addStep("ui forms", this, "readUiForms", QStringList() << "settings", true);
+		startup.addStep("ogre", this, "setupOgre", QStringList() << "settings");
+		startup.addStep("input", this, "setupInput", QStringList() << "ogre");
+		startup.addStep("ui setup", this, "setupUserInterface", QStringList() << "input");
+		startup.addStep("ui", this, "loadUserInterface", QStringList() << "ui setup" << "ui forms");
+		startup.addStep("scene", this, "setupScene", QStringList() << "ogre" << "input");
+		startup.run();
 		
-		QWebView *web  = new QWebView();
-		web->load(QUrl("http://mrdoob.com/projects/chromeexperiments/ball_pool/"));
-		ui->layout()->addWidget(web);
-
-		mOgreCore->getUiManager()->setActiveWidget(ui);
-		mOgreCore->getUiManager()->setInputManager(mInputManager);
+		// the main loop keeps the loading screen animated while resources load
+		mResourceLoader = new ResourceLoader(this);
+		connect(mResourceLoader, SIGNAL(progressChanged(int, int, const QString &)), this,
+				SLOT(showLoadingProgress(int, int, const QString &)));
+		connect(mResourceLoader, SIGNAL(finished()), this, SLOT(showGameScreen()));
+		mResourceLoader->addAllGroups();
+		mResourceLoader->start();
 		
 		QCoreApplication::instance()->processEvents();
 		
-		SceneManager::getSingletonPtr()->setupDefaultScene();
-		
-		mGame = new Game();
-		mGame->setInputManager(mInputManager);
-		
 		Ogre::WindowEventUtilities::messagePump();
 		
+		// the game logic runs on a worker while the main thread loads resources and paints the UI
+		mJobSystem = new JobSystem(mWorkerThreads);
+		mFrameJobs = new JobGraph();
+		mFrameJobs->addJob(this, &Core::simulate);
+		const int resourceJob = mFrameJobs->addJob(this, &Core::loadResources, QList<int> (),
+				JobSystem::MainThread);
+		// progress of the resource loader shows on the loading screen
+		mFrameJobs->addJob(this, &Core::updateUserInterface, QList<int> () << resourceJob,
+				JobSystem::MainThread);
 		
-		// launch other threads here
-		
+		Ogre::LogManager::getSingleton().logMessage("Running frame jobs on "
+				+ Ogre::StringConverter::toString(mJobSystem->getWorkerCount())
+				+ " worker threads and the main thread.");
 
 		mFrameUpdateRate = Ogre::Real(1) / Ogre::Real(30);
 		mFrameTime.start();
+		mRenderTime.start();
+		unsigned int frameCount = 0;
+		bool replayFinishedLogged = false;
 		
 		
 		// Main game loop
@@ -110,28 +147,72 @@ namespace Cutexture
 			QCoreApplication::instance()->processEvents();
 			Ogre::WindowEventUtilities::messagePump();
 			
-			mOgreCore->processWindowEvents(mInputManager);
+			bool frameDirty = mOgreCore->processWindowEvents(mInputManager);
 			
 			// grab the mouse and keyboard state
 			mInputManager->updateInputState();
 			
+			if (mReplaySource)
+			{
+				// use the recorded frame durations to make frame-locked replays deterministic
+				if (!mReplaySource->isRealTime() && mReplaySource->getLastFrameDuration() > 0)
+				{
+					mFrameUpdateRate = Ogre::Real(mReplaySource->getLastFrameDuration()) / Ogre::Real(1000);
+				}
+				
+				if (mReplaySource->isFinished() && !replayFinishedLogged)
+				{
+					Ogre::LogManager::getSingleton().logMessage("Input replay finished after "
+							+ Ogre::StringConverter::toString(mReplaySource->getFrameCount()) + " frames.");
+					replayFinishedLogged = true;
+				}
+			}
+			
 			if (mEndCoreLoop)
 			{
 				break;
 			}
 
+			frameDirty |= mInputManager->hasPendingInputEvents();
 			mInputManager->emitInputEvents();
-			mGame->applyGameLogic();
+			
+			// advance the game logic in fixed steps by the duration of the last frame
+			mGame->collectInput();
+			mSimulationAccumulator += mFrameUpdateRate;
+			
+			mFrameDirty = false;
+			mJobSystem->run(*mFrameJobs);
+			frameDirty |= mFrameDirty;
+			
+			// render between the last two logic states
+			frameDirty |= mGame->interpolate(mSimulationAccumulator / mSimulationStep);
+			
+			// only moves the cursor quad; the UI texture is not touched
+			mOgreCore->updateCursor(mInputManager);
+			
+			const bool windowVisible = mOgreCore->isWindowVisible();
+			const bool windowInBackground = !windowVisible || !mOgreCore->isWindowActive();
 			
 			UiManager *uiMan = mOgreCore->getUiManager();
-			if (uiMan->isUiDirty())
+			
+			frameDirty |= mFrameInvalidated;
+			
+			bool keepAliveDue = mKeepAliveInterval > 0 && mRenderTime.elapsed() >= mKeepAliveInterval;
+			
+			if (windowVisible && (!mOnDemandRendering || frameDirty || keepAliveDue))
 			{
-				uiMan->renderIntoTexture(Ogre::TextureManager::getSingletonPtr()->getByName(UI_TEXTURE_NAME));
-				uiMan->setUiDirty(false);
+				mOgreCore->renderFrame();
+				mRenderTime.restart();
+				mFrameInvalidated = false;
+				
+				if (mStartupTime.isValid())
+				{
+					Ogre::LogManager::getSingleton().logMessage("First frame rendered after "
+							+ Ogre::StringConverter::toString(mStartupTime.elapsed()) + " ms.");
+					mStartupTime = QTime();
+				}
 			}
 			
-			mOgreCore->renderFrame();
-			
 			
 			// restart game loop timer and update frame duration
 			int duration = mFrameTime.restart();
@@ -140,28 +221,386 @@ namespace Cutexture
 			// NOTE: For input, the actual frame time delta should be used and not an average.
 			mFrameUpdateRate = Ogre::Real(duration) / Ogre::Real(1000);
 			
-			SleepThread::msleep(1);
+			++frameCount;
+			if (mFrameLimit > 0 && frameCount >= mFrameLimit)
+			{
+				mEndCoreLoop = true;
+			}
+			
+			// without changes, wait longer before polling for new events again
+			int sleepTime = (mOnDemandRendering && !frameDirty && !uiMan->isAnimating())
+					? mIdlePollInterval : 1;
+			
+			// leave the machine to other applications while in the background
+			if (windowInBackground)
+			{
+				sleepTime = qMax(sleepTime, mBackgroundTickInterval);
+			}
+			
+			SleepThread::msleep(sleepTime);
 		}
 		
+		mInputManager->stopRecording();
 	}
 	
-	void Core::shutdown()
+	void Core::simulate()
 	{
-		mEndCoreLoop = true;
+		int simulationSteps = 0;
+		while (mSimulationAccumulator >= mSimulationStep && simulationSteps < mMaxSimulationSteps)
+		{
+			mGame->applyGameLogic(mSimulationStep);
+			mSimulationAccumulator -= mSimulationStep;
+			++simulationSteps;
+		}
+		
+		// drop the time the logic cannot catch up with instead of spiralling
+		if (mSimulationAccumulator >= mSimulationStep)
+		{
+			mSimulationAccumulator -= Ogre::Math::Floor(mSimulationAccumulator / mSimulationStep)
+					* mSimulationStep;
+		}
 	}
-
-	QWidget* Core::loadUiFile(const QString &aUiFile, QWidget *aParent)
+	
+	void Core::loadResources()
+	{
+		mFrameDirty |= mResourceLoader->tick(DemoConstants::LOADING_FRAME_BUDGET);
+	}
+	
+	void Core::updateUserInterface()
+	{
+		UiManager *uiMan = mOgreCore->getUiManager();
+		Ogre::TexturePtr uiTexture = Ogre::TextureManager::getSingletonPtr()->getByName(UI_TEXTURE_NAME);
+		
+		// nobody can see the UI while the window is hidden
+		if (!mOgreCore->isWindowVisible())
+		{
+			uiMan->hibernate(uiTexture, mReleaseHiddenUiResources);
+		}
+		else if (uiMan->isHibernating())
+		{
+			uiMan->resume(uiTexture);
+		}
+		
+		// changes posted by game threads become visible in this frame
+		uiMan->applyCommands();
+		
+		// animations advance once per frame
+		uiMan->advanceFrame(Ogre::Root::getSingleton().getTimer()->getMilliseconds());
+		
+		if (uiMan->isRepaintDue() && !uiMan->isHibernating())
+		{
+			// with late latching, the texture is updated during renderFrame()
+			if (!uiMan->isLateLatching())
+			{
+				uiMan->renderIntoTexture(uiTexture);
+				uiMan->setUiDirty(false);
+			}
+			
+			// the bounds only depend on the widget geometry
+			mOgreCore->updateUserInterfaceBounds();
+			mFrameDirty = true;
+		}
+	}
+	
+	void Core::setupSettings()
+	{
+		mSettings = new Settings();
+		loadSettings();
+	}
+	
+	void Core::prefetchResources()
+	{
+		OgreCore::prefetchResources(QCoreApplication::applicationDirPath() + QDir::separator());
+	}
+	
+	void Core::readUiForms()
+	{
+		// the helper process reads its own forms
+		if (mUiRemote)
+		{
+			return;
+		}
+		
+		mUiPack = new ResourcePack();
+		if (mUiPack->open(DemoConstants::UI_RESOURCE_PACK) && mUiPack->contains("game.ui"))
+		{
+			mGameForm = mUiPack->read("game.ui");
+			return;
+		}
+		
+		QFile file("game.ui");
+		if (!file.open(QFile::ReadOnly))
+		{
+			EXCEPTION("Cannot read game.ui.", "Core::readUiForms()");
+		}
+		mGameForm = file.readAll();
+	}
+	
+	void Core::setupOgre()
+	{
+		mInputManager = new InputManager();
+		
+		mOgreCore = new OgreCore();
+		bool setupResult = mOgreCore->setupOgre(mUiRemote ? Enums::UiBackendRemoteProcess
+				: Enums::UiBackendGraphicsView);
+		
+		if (!setupResult)
+		{
+			EXCEPTION("Failed to setup OgreCore.", "Core::setupOgre()");
+		}
+	}
+	
+	void Core::setupInput()
+	{
+		if (mInputReplayFile.isEmpty())
+		{
+			mInputManager->initialize(mOgreCore->getOgreRenderWindow(), mUiCursorLayer);
+		}
+		else
+		{
+			mReplaySource = new ReplayInputSource(mInputReplayFile, mInputReplayRealTime);
+			mInputManager->initialize(mReplaySource);
+		}
+		
+		if (!mInputRecordingFile.isEmpty())
+		{
+			mInputManager->startRecording(mInputRecordingFile);
+		}
+	}
+	
+	void Core::setupUserInterface()
+	{
+		UiManager *uiManager = mOgreCore->getUiManager();
+		uiManager->setTileDiffing(mUiTileDiffing, mUiTileSize);
+		uiManager->setRenderScale(mUiRenderScale);
+		uiManager->setVirtualResolution(mUiVirtualResolution);
+		uiManager->setTextureFormat(mUiTextureFormat);
+		uiManager->setTintColour(mUiTintColour);
+		uiManager->setStaticUi(mUiStatic);
+		uiManager->setFrameClock(mUiFrameClock);
+		uiManager->setMaxRepaintRate(mUiMaxRepaintRate);
+		uiManager->setParallelRendering(mUiParallelRendering);
+		uiManager->setInputManager(mInputManager);
+		
+		mOgreCore->setupUserInterface();
+		
+		if (mUiLateLatching)
+		{
+			uiManager->setLateLatching(Ogre::Root::getSingleton().getSceneManager(
+					DemoConstants::SCENE_MANAGER_NAME), Ogre::TextureManager::getSingleton().getByName(
+					UI_TEXTURE_NAME));
+		}
+		
+		if (mUiCursorLayer)
+		{
+			mOgreCore->setupCursorLayer();
+		}
+	}
+	
+	void Core::loadUserInterface()
+	{
+		const QString webPage = "http://mrdoob.com/projects/chromeexperiments/ball_pool/";
+		
+		if (mUiRemote)
+		{
+			// the helper builds the same UI as below in its own process
+			if (!mOgreCore->getUiManager()->startRemoteUi(QCoreApplication::applicationDirPath()
+					+ "/ui-helper", QStringList() << "game.ui" << webPage))
+			{
+				EXCEPTION("Failed to start the UI helper process.", "Core::loadUserInterface()");
+			}
+			return;
+		}
+		
+		mScreens = new ScreenRegistry(mOgreCore->getUiManager());
+		mScreens->registerScreen("game", mGameForm);
+		
+		QWidget *ui = mScreens->getScreen("game");
+		ui->setAttribute(Qt::WA_TranslucentBackground);
+		
+		QWebView *web  = new QWebView();
+		web->load(QUrl(webPage));
+		ui->layout()->addWidget(web);
+		
+		// shown until the resources are loaded, then replaced by the game screen
+		QWidget *loadingScreen = new QWidget();
+		loadingScreen->setAttribute(Qt::WA_TranslucentBackground);
+		
+		mLoadingStatus = new QLabel();
+		mLoadingBar = new QProgressBar();
+		mLoadingBar->setRange(0, 0);
+		
+		QVBoxLayout *layout = new QVBoxLayout(loadingScreen);
+		layout->addStretch();
+		layout->addWidget(mLoadingStatus);
+		layout->addWidget(mLoadingBar);
+		
+		UiManager *uiManager = mOgreCore->getUiManager();
+		uiManager->setActiveWidget(loadingScreen);
+		
+		// apply the window size now, so that the game screen is prewarmed at its final layout
+		mOgreCore->processWindowEvents(mInputManager);
+		
+		mScreens->prewarmScreen("game");
+		
+		// the status shows resource names, which are not known yet
+		QString printableAscii;
+		for (char c = ' '; c <= '~'; ++c)
+		{
+			printableAscii += QLatin1Char(c);
+		}
+		uiManager->prewarmText(mLoadingStatus->font(), printableAscii);
+		uiManager->logPrewarmStatistics();
+	}
+	
+	void Core::setupScene()
+	{
+		SceneManager::getSingletonPtr()->setupDefaultScene();
+		
+		mGame = new Game();
+		mGame->setInputManager(mInputManager);
+	}
+	
+	void Core::showLoadingProgress(int aLoaded, int aTotal, const QString &aStatus)
+	{
+		if (!mLoadingBar)
+		{
+			return;
+		}
+		
+		// a range of 0 shows a busy indicator until the number of resources is known
+		mLoadingBar->setRange(0, aTotal);
+		mLoadingBar->setValue(aLoaded);
+		mLoadingStatus->setText(aStatus);
+	}
+	
+	void Core::showGameScreen()
 	{
-		QUiLoader uiLoader;
+		if (!mScreens)
+		{
+			return;
+		}
+		
+		mScreens->showScreen("game");
+		mLoadingBar = NULL;
+		mLoadingStatus = NULL;
+	}
 	
-		QFile file(aUiFile);
-		assert(file.exists());
-		file.open(QFile::ReadOnly);
+	void Core::loadSettings()
+	{
+		QHash < QString, QVariant > mainLoopDefaults;
+		mainLoopDefaults.insert(SETTINGS_RENDER_MODE_KEY, SETTINGS_RENDER_MODE_VAL);
+		mainLoopDefaults.insert(SETTINGS_KEEP_ALIVE_RATE_KEY, SETTINGS_KEEP_ALIVE_RATE_VAL);
+		mainLoopDefaults.insert(SETTINGS_IDLE_POLL_INTERVAL_KEY, SETTINGS_IDLE_POLL_INTERVAL_VAL);
+		mainLoopDefaults.insert(SETTINGS_BACKGROUND_TICK_RATE_KEY, SETTINGS_BACKGROUND_TICK_RATE_VAL);
+		mainLoopDefaults.insert(SETTINGS_RELEASE_HIDDEN_UI_KEY, SETTINGS_RELEASE_HIDDEN_UI_VAL);
+		mainLoopDefaults.insert(SETTINGS_SIMULATION_RATE_KEY, SETTINGS_SIMULATION_RATE_VAL);
+		mainLoopDefaults.insert(SETTINGS_MAX_SIMULATION_STEPS_KEY, SETTINGS_MAX_SIMULATION_STEPS_VAL);
+		mainLoopDefaults.insert(SETTINGS_WORKER_THREADS_KEY, SETTINGS_WORKER_THREADS_VAL);
+		mSettings->setDefaultValues(SETTINGS_CATEGORY_MAIN_LOOP, mainLoopDefaults);
+		
+		mOnDemandRendering = mSettings->getValue(SETTINGS_CATEGORY_MAIN_LOOP,
+				SETTINGS_RENDER_MODE_KEY).toString() == SETTINGS_RENDER_MODE_ON_DEMAND_VAL;
+		
+		int keepAliveRate = mSettings->getValue(SETTINGS_CATEGORY_MAIN_LOOP,
+				SETTINGS_KEEP_ALIVE_RATE_KEY).toInt();
+		mKeepAliveInterval = (keepAliveRate > 0) ? 1000 / keepAliveRate : 0;
+		
+		mIdlePollInterval = qMax(1, mSettings->getValue(SETTINGS_CATEGORY_MAIN_LOOP,
+				SETTINGS_IDLE_POLL_INTERVAL_KEY).toInt());
+		
+		int backgroundTickRate = mSettings->getValue(SETTINGS_CATEGORY_MAIN_LOOP,
+				SETTINGS_BACKGROUND_TICK_RATE_KEY).toInt();
+		mBackgroundTickInterval = (backgroundTickRate > 0) ? 1000 / backgroundTickRate : 0;
+		
+		mReleaseHiddenUiResources = mSettings->getValue(SETTINGS_CATEGORY_MAIN_LOOP,
+				SETTINGS_RELEASE_HIDDEN_UI_KEY).toBool();
+		
+		mSimulationStep = Ogre::Real(1) / qMax(1, mSettings->getValue(SETTINGS_CATEGORY_MAIN_LOOP,
+				SETTINGS_SIMULATION_RATE_KEY).toInt());
+		mMaxSimulationSteps = qMax(1, mSettings->getValue(SETTINGS_CATEGORY_MAIN_LOOP,
+				SETTINGS_MAX_SIMULATION_STEPS_KEY).toInt());
+		mWorkerThreads = mSettings->getValue(SETTINGS_CATEGORY_MAIN_LOOP,
+				SETTINGS_WORKER_THREADS_KEY).toInt();
+		
+		QHash < QString, QVariant > userInterfaceDefaults;
+		userInterfaceDefaults.insert(SETTINGS_TILE_DIFFING_KEY, SETTINGS_TILE_DIFFING_VAL);
+		userInterfaceDefaults.insert(SETTINGS_TILE_SIZE_KEY, SETTINGS_TILE_SIZE_VAL);
+		userInterfaceDefaults.insert(SETTINGS_RENDER_SCALE_KEY, SETTINGS_RENDER_SCALE_VAL);
+		userInterfaceDefaults.insert(SETTINGS_VIRTUAL_RESOLUTION_KEY, SETTINGS_VIRTUAL_RESOLUTION_VAL);
+		userInterfaceDefaults.insert(SETTINGS_TEXTURE_FORMAT_KEY, SETTINGS_TEXTURE_FORMAT_VAL);
+		userInterfaceDefaults.insert(SETTINGS_TINT_COLOUR_KEY, SETTINGS_TINT_COLOUR_VAL);
+		userInterfaceDefaults.insert(SETTINGS_STATIC_UI_KEY, SETTINGS_STATIC_UI_VAL);
+		userInterfaceDefaults.insert(SETTINGS_CURSOR_LAYER_KEY, SETTINGS_CURSOR_LAYER_VAL);
+		userInterfaceDefaults.insert(SETTINGS_LATE_LATCHING_KEY, SETTINGS_LATE_LATCHING_VAL);
+		userInterfaceDefaults.insert(SETTINGS_FRAME_CLOCK_KEY, SETTINGS_FRAME_CLOCK_VAL);
+		userInterfaceDefaults.insert(SETTINGS_MAX_REPAINT_RATE_KEY, SETTINGS_MAX_REPAINT_RATE_VAL);
+		userInterfaceDefaults.insert(SETTINGS_PARALLEL_RENDERING_KEY, SETTINGS_PARALLEL_RENDERING_VAL);
+		userInterfaceDefaults.insert(SETTINGS_REMOTE_UI_KEY, SETTINGS_REMOTE_UI_VAL);
+		mSettings->setDefaultValues(SETTINGS_CATEGORY_USER_INTERFACE, userInterfaceDefaults);
+		
+		mUiTileDiffing = mSettings->getValue(SETTINGS_CATEGORY_USER_INTERFACE,
+				SETTINGS_TILE_DIFFING_KEY).toBool();
+		mUiTileSize = qMax(8, mSettings->getValue(SETTINGS_CATEGORY_USER_INTERFACE,
+				SETTINGS_TILE_SIZE_KEY).toInt());
+		
+		mUiRenderScale = qBound(0.1, mSettings->getValue(SETTINGS_CATEGORY_USER_INTERFACE,
+				SETTINGS_RENDER_SCALE_KEY).toDouble(), 4.0);
+		
+		const QStringList resolution = mSettings->getValue(SETTINGS_CATEGORY_USER_INTERFACE,
+				SETTINGS_VIRTUAL_RESOLUTION_KEY).toString().split('x');
+		mUiVirtualResolution = (resolution.size() == 2) ? QSize(resolution.at(0).toInt(),
+				resolution.at(1).toInt()) : QSize();
+		
+		const QString textureFormat = mSettings->getValue(SETTINGS_CATEGORY_USER_INTERFACE,
+				SETTINGS_TEXTURE_FORMAT_KEY).toString();
+		if (textureFormat == SETTINGS_TEXTURE_FORMAT_ARGB4444_VAL)
+		{
+			mUiTextureFormat = Enums::TextureFormatARGB4444;
+		}
+		else if (textureFormat == SETTINGS_TEXTURE_FORMAT_ARGB1555_VAL)
+		{
+			mUiTextureFormat = Enums::TextureFormatARGB1555;
+		}
+		else if (textureFormat == SETTINGS_TEXTURE_FORMAT_ALPHA8_VAL)
+		{
+			mUiTextureFormat = Enums::TextureFormatAlpha8;
+		}
+		else
+		{
+			mUiTextureFormat = Enums::TextureFormatARGB8888;
+		}
+		
+		mUiTintColour = QColor(mSettings->getValue(SETTINGS_CATEGORY_USER_INTERFACE,
+				SETTINGS_TINT_COLOUR_KEY).toString());
+		
+		mUiStatic = mSettings->getValue(SETTINGS_CATEGORY_USER_INTERFACE, SETTINGS_STATIC_UI_KEY).toBool();
+		mUiCursorLayer = mSettings->getValue(SETTINGS_CATEGORY_USER_INTERFACE,
+				SETTINGS_CURSOR_LAYER_KEY).toBool();
+		mUiLateLatching = mSettings->getValue(SETTINGS_CATEGORY_USER_INTERFACE,
+				SETTINGS_LATE_LATCHING_KEY).toBool();
+		mUiFrameClock = mSettings->getValue(SETTINGS_CATEGORY_USER_INTERFACE,
+				SETTINGS_FRAME_CLOCK_KEY).toBool();
+		mUiMaxRepaintRate = qMax(0, mSettings->getValue(SETTINGS_CATEGORY_USER_INTERFACE,
+				SETTINGS_MAX_REPAINT_RATE_KEY).toInt());
+		mUiParallelRendering = mSettings->getValue(SETTINGS_CATEGORY_USER_INTERFACE,
+				SETTINGS_PARALLEL_RENDERING_KEY).toBool();
+		mUiRemote = mSettings->getValue(SETTINGS_CATEGORY_USER_INTERFACE, SETTINGS_REMOTE_UI_KEY).toBool();
+	}
 	
-		QWidget *generatedWidget = uiLoader.load(&file, aParent);
+	void Core::setInputRecordingFile(const QString &aFileName)
+	{
+		mInputRecordingFile = aFileName;
+	}
 	
-		file.close();
+	void Core::setInputReplayFile(const QString &aFileName, bool aRealTime)
+	{
+		mInputReplayFile = aFileName;
+		mInputReplayRealTime = aRealTime;
+	}
 	
-		return generatedWidget;
+	void Core::shutdown()
+	{
+		mEndCoreLoop = true;
 	}
 }
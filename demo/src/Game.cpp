@@ -48,6 +48,10 @@ namespace Cutexture
 		{
 			EXCEPTION("OgreCore is not initialized.", "Game::Game()");
 		}
+		
+		Ogre::Camera* mainCamera = ViewManager::getSingletonPtr()->getPrimaryViewport()->getCamera();
+		mCameraPosition = mPreviousCameraPosition = mainCamera->getPosition();
+		mCameraOrientation = mPreviousCameraOrientation = mainCamera->getOrientation();
 	}
 
 Game::~Game()
@@ -74,7 +78,18 @@ void Game::setInputManager(InputManager *aInputManager)
 	}
 }
 
-void Game::applyGameLogic()
+void Game::collectInput()
+{
+	assert(mInputManager);
+	
+	// applied by the next logic step, however many frames it takes until then
+	if (mInputManager->getMouseButtonsPressed() & Qt::RightButton)
+	{
+		mPendingMouseDelta += mInputManager->getRelativeMouseMovement();
+	}
+}
+
+void Game::applyGameLogic(Ogre::Real aTimeStep)
 {
 	assert(mInputManager);
 	
@@ -82,12 +97,9 @@ void Game::applyGameLogic()
 	const float camMovSpeed = 50;
 	// rotate the camera x degrees per second
 	const Ogre::Degree camRotSpeed(30);
-	// fraction of a second since last update
-	const Ogre::Real frameFraction = Core::getSingletonPtr()->getFrameUpdateRate();
 
-	Ogre::Camera* mainCamera = ViewManager::getSingletonPtr()->getPrimaryViewport()->getCamera();
-
-	QPoint mouseDelta = mInputManager->getRelativeMouseMovement();
+	mPreviousCameraPosition = mCameraPosition;
+	mPreviousCameraOrientation = mCameraOrientation;
 
 	Ogre::Degree relativePitch(0);
 	Ogre::Degree relativeYaw(0);
@@ -115,47 +127,59 @@ void Game::applyGameLogic()
 		vecMovement += Ogre::Vector3(camMovSpeed, 0.0, 0.0);
 	}
 
-	if (movementsActive != 0)
-	{
-		vecMovement *= frameFraction;
-		mainCamera->moveRelative(vecMovement);
-	}
+	// same as Ogre::Camera::moveRelative()
+	mCameraPosition += mCameraOrientation * (vecMovement * aTimeStep);
 
 	// ***** Handle Rotations *****
 	// Keyboard rotations
 	if (movementsActive & Enums::YawCounterClock)
 	{
-		relativeYaw += camRotSpeed * frameFraction;
+		relativeYaw += camRotSpeed * aTimeStep;
 	}
 	else if (movementsActive & Enums::YawClock)
 	{
-		relativeYaw += -camRotSpeed * frameFraction;
+		relativeYaw += -camRotSpeed * aTimeStep;
 	}
 
 	if (movementsActive & Enums::PitchUp)
 	{
-		relativePitch += camRotSpeed * frameFraction;
+		relativePitch += camRotSpeed * aTimeStep;
 	}
 	else if (movementsActive & Enums::PitchDown)
 	{
-		relativePitch += -camRotSpeed * frameFraction;
+		relativePitch += -camRotSpeed * aTimeStep;
 	}
 
-	// Mouse rotations                
-	if (mInputManager->getMouseButtonsPressed() & Qt::RightButton)
-	{
-		// The frame rate doesn't need to be compensated for here because this is based on the mouse delta
-		// which is constant in time so naturally variable with the frame rate.
-		relativeYaw += Ogre::Degree(Ogre::Real(mouseDelta.x()) / Ogre::Real(10));
-		relativePitch += Ogre::Degree(Ogre::Real(mouseDelta.y()) / Ogre::Real(10));
-	}
+	// Mouse rotations
+	// The time step doesn't need to be compensated for here because this is based on the mouse delta
+	// which is constant in time.
+	relativeYaw += Ogre::Degree(Ogre::Real(mPendingMouseDelta.x()) / Ogre::Real(10));
+	relativePitch += Ogre::Degree(Ogre::Real(mPendingMouseDelta.y()) / Ogre::Real(10));
+	mPendingMouseDelta = QPoint();
+
+	// same as Ogre::Camera::yaw() around the fixed yaw axis and Ogre::Camera::pitch()
+	mCameraOrientation = Ogre::Quaternion(relativeYaw, Ogre::Vector3::UNIT_Y) * mCameraOrientation
+			* Ogre::Quaternion(relativePitch, Ogre::Vector3::UNIT_X);
+	mCameraOrientation.normalise();
+}
 
-	// Rotate camera based on movements
-	if ((relativeYaw != Ogre::Degree(0)) || (relativePitch != Ogre::Degree(0)))
+bool Game::interpolate(Ogre::Real aAlpha)
+{
+	const Ogre::Vector3 position = mPreviousCameraPosition + (mCameraPosition
+			- mPreviousCameraPosition) * aAlpha;
+	const Ogre::Quaternion orientation = Ogre::Quaternion::Slerp(aAlpha,
+			mPreviousCameraOrientation, mCameraOrientation, true);
+
+	Ogre::Camera* mainCamera = ViewManager::getSingletonPtr()->getPrimaryViewport()->getCamera();
+
+	if (mainCamera->getPosition() == position && mainCamera->getOrientation() == orientation)
 	{
-		mainCamera->yaw(relativeYaw);
-		mainCamera->pitch(relativePitch);
+		return false;
 	}
+
+	mainCamera->setPosition(position);
+	mainCamera->setOrientation(orientation);
+	return true;
 }
 
 void Game::initiateShutdown()
@@ -30,14 +30,20 @@
 #include "Constants.h"
 #include "InputManager.h"
 #include "ViewManager.h"
+#include "PixelConversion.h"
+#include "CursorLayer.h"
+#include "DemoConstants.h"
+#include "PackArchive.h"
 
 template<> Cutexture::OgreCore* Ogre::Singleton<Cutexture::OgreCore>::ms_Singleton = 0;
 
 namespace Cutexture
 {
 	OgreCore::OgreCore() :
-		mUiManager(NULL), mOgreRenderWindow(NULL), mOgreRoot(NULL), mViewManager(NULL),
-				mSceneManager(NULL), mRenderWindowWidth(0), mRenderWindowHeight(0)
+		mUiManager(NULL), mCursorLayer(NULL), mOgreRenderWindow(NULL), mOgreRoot(NULL),
+				mPackArchiveFactory(NULL), mViewManager(NULL),
+				mSceneManager(NULL), mRenderWindowWidth(0), mRenderWindowHeight(0),
+				mWindowEventsPending(true), mWindowActive(true), mWindowVisible(true)
 	{
 		// set default configuration values for this component
 		QHash < QString, QVariant > engineType;
@@ -65,6 +71,12 @@ namespace Cutexture
 	
 	OgreCore::~OgreCore()
 	{
+		if (mOgreRenderWindow)
+		{
+			Ogre::WindowEventUtilities::removeWindowEventListener(mOgreRenderWindow, this);
+		}
+		
+		delete mCursorLayer;
 		delete mSceneManager;
 		delete mViewManager;
 		delete mUiManager;
@@ -72,9 +84,10 @@ namespace Cutexture
 		
 		// deleting Ogre::Root will automatically delete all other Ogre-managed objects
 		delete mOgreRoot;
+		delete mPackArchiveFactory;
 	}
 	
-	bool OgreCore::setupOgre()
+	bool OgreCore::setupOgre(Enums::UiBackend aUiBackend)
 	{
 		QString resourcePath = QCoreApplication::instance()->applicationDirPath()
 				+ QDir::separator();
@@ -86,7 +99,8 @@ namespace Cutexture
 #endif
 		mOgreRoot = new Ogre::Root();
 		
-		setupResources(resourcePath);
+		mPackArchiveFactory = new PackArchiveFactory();
+		Ogre::ArchiveManager::getSingleton().addArchiveFactory(mPackArchiveFactory);
 		
 		if (!setupRenderer())
 		{
@@ -95,10 +109,14 @@ namespace Cutexture
 
 		// initialize Ogre and create a render window
 		mOgreRenderWindow = mOgreRoot->initialise(true);
+		Ogre::WindowEventUtilities::addWindowEventListener(mOgreRenderWindow, this);
+		
+		// indexed after creating the window, which gives prefetchResources() a head start
+		setupResources(resourcePath);
 		
 		
 		// create the UI widget overlay manager
-		mUiManager = new UiManager();
+		mUiManager = new UiManager(aUiBackend);
 		
 		mViewManager = new ViewManager(*mOgreRenderWindow);
 		mSceneManager = new SceneManager();
@@ -117,7 +135,35 @@ namespace Cutexture
 			EXCEPTION("Cannot setup user interface. No mOgreWidget.", "OgreCore::setupUserInterface()");
 		}
 
-		mSceneManager->setupUserInterfaceElements();
+		mSceneManager->setupUserInterfaceElements(Utility::toOgrePixelFormat(mUiManager->getTextureFormat()));
+	}
+	
+	void OgreCore::setupCursorLayer()
+	{
+		assert(!mCursorLayer);
+		
+		mCursorLayer = new CursorLayer(Ogre::Root::getSingletonPtr()->getSceneManager(
+				DemoConstants::SCENE_MANAGER_NAME), CURSOR_TEXTURE_NAME);
+	}
+	
+	void OgreCore::updateCursor(InputManager *aInputManager)
+	{
+		if (!mCursorLayer)
+		{
+			return;
+		}
+		
+		mCursorLayer->setCursor(mUiManager->getCursor());
+		mCursorLayer->setPosition(aInputManager->getMousePosition(), QSize(mRenderWindowWidth,
+				mRenderWindowHeight));
+	}
+	
+	void OgreCore::updateUserInterfaceBounds()
+	{
+		assert(mSceneManager && mUiManager);
+		
+		mSceneManager->setUserInterfaceBounds(mUiManager->getContentBounds(), QSize(
+				mRenderWindowWidth, mRenderWindowHeight));
 	}
 	
 	void OgreCore::renderFrame()
@@ -135,8 +181,11 @@ namespace Cutexture
 		return mOgreRenderWindow;
 	}
 	
-	void OgreCore::processWindowEvents(InputManager *aInputManager)
+	bool OgreCore::processWindowEvents(InputManager *aInputManager)
 	{
+		bool windowChanged = mWindowEventsPending;
+		mWindowEventsPending = false;
+		
 		unsigned int currWidth = 0;
 		unsigned int currHeight = 0;
 		unsigned int unused = 0;
@@ -157,6 +206,80 @@ namespace Cutexture
 			
 			mRenderWindowWidth = currWidth;
 			mRenderWindowHeight = currHeight;
+			windowChanged = true;
+		}
+		
+		return windowChanged;
+	}
+	
+	void OgreCore::windowMoved(Ogre::RenderWindow *aRenderWindow)
+	{
+		mWindowEventsPending = true;
+	}
+	
+	void OgreCore::windowResized(Ogre::RenderWindow *aRenderWindow)
+	{
+		mWindowEventsPending = true;
+	}
+	
+	void OgreCore::windowFocusChange(Ogre::RenderWindow *aRenderWindow)
+	{
+		// Ogre updates these flags on activation, minimization and occlusion before notifying us
+		mWindowActive = aRenderWindow->isActive();
+		mWindowVisible = aRenderWindow->isVisible();
+		mWindowEventsPending = true;
+	}
+	
+	void OgreCore::prefetchResources(const QString &aResourcePath)
+	{
+		Ogre::ConfigFile cf;
+		try
+		{
+			cf.load((aResourcePath + "resources.cfg").toStdString());
+		}
+		catch (const Ogre::Exception &)
+		{
+			// setupResources() reports it
+			return;
+		}
+		
+		Ogre::ConfigFile::SectionIterator seci = cf.getSectionIterator();
+		while (seci.hasMoreElements())
+		{
+			Ogre::ConfigFile::SettingsMultiMap *settings = seci.getNext();
+			
+			for (Ogre::ConfigFile::SettingsMultiMap::iterator i = settings->begin(); i
+					!= settings->end(); ++i)
+			{
+				QString location = QString::fromStdString(i->second);
+#if OGRE_PLATFORM == OGRE_PLATFORM_APPLE
+				location = qApp->applicationDirPath() + "/" + location;
+#endif
+				const QFileInfo info(location);
+				
+				if (info.isDir())
+				{
+					// Ogre lists every directory of a location when indexing it
+					QDirIterator it(location, QDir::AllEntries | QDir::NoDotAndDotDot,
+							QDirIterator::Subdirectories);
+					while (it.hasNext())
+					{
+						it.next();
+						it.fileInfo().size();
+					}
+				}
+				else if (info.isFile())
+				{
+					// pull zip archives and resource packs into the page cache
+					QFile archive(location);
+					if (archive.open(QFile::ReadOnly))
+					{
+						while (!archive.read(1024 * 1024).isEmpty())
+						{
+						}
+					}
+				}
+			}
 		}
 	}
 	
@@ -39,7 +39,8 @@ template<> Cutexture::SceneManager* Ogre::Singleton<Cutexture::SceneManager>::ms
 
 namespace Cutexture
 {
-	SceneManager::SceneManager()
+	SceneManager::SceneManager() :
+		mUserInterfaceScreen(NULL)
 	{
 		// Create the Ogre SceneManager, in this case a generic one. Ogre::Root will hold onto the 
 		// reference so we don't need to keep it around.
@@ -94,7 +95,7 @@ namespace Cutexture
 				groundNode->getPosition());
 	}
 	
-	void SceneManager::setupUserInterfaceElements()
+	void SceneManager::setupUserInterfaceElements(Ogre::PixelFormat aTextureFormat)
 	{
 		Ogre::SceneManager *sceneManager = Ogre::Root::getSingletonPtr()->getSceneManager(
 				DemoConstants::SCENE_MANAGER_NAME);
@@ -114,11 +115,38 @@ namespace Cutexture
 
 		// assign to mini screen
 		miniScreen->setMaterial("RttMat");
+		mUserInterfaceScreen = miniScreen;
 		
 		Ogre::TexturePtr txtr = Ogre::TextureManager::getSingleton().createManual(
 				UI_TEXTURE_NAME, "General", Ogre::TEX_TYPE_2D, 512, 512, 0,
-				Ogre::PF_A8R8G8B8, Ogre::TU_DYNAMIC_WRITE_ONLY);
+				aTextureFormat, Ogre::TU_DYNAMIC_WRITE_ONLY);
 		mat->getTechnique(0)->getPass(0)->createTextureUnitState(UI_TEXTURE_NAME);
 		txtr->load();
 	}
+	
+	void SceneManager::setUserInterfaceBounds(const QRect &aBounds, const QSize &aWindowSize)
+	{
+		if (!mUserInterfaceScreen)
+		{
+			return;
+		}
+		
+		const QRect bounds = aBounds & QRect(QPoint(0, 0), aWindowSize);
+		if (bounds.isEmpty())
+		{
+			mUserInterfaceScreen->setVisible(false);
+			return;
+		}
+		
+		// texture coordinates span the window; the texture unit maps them to the UI part of the texture
+		const Ogre::Real uLeft = Ogre::Real(bounds.left()) / aWindowSize.width();
+		const Ogre::Real uRight = Ogre::Real(bounds.left() + bounds.width()) / aWindowSize.width();
+		const Ogre::Real vTop = Ogre::Real(bounds.top()) / aWindowSize.height();
+		const Ogre::Real vBottom = Ogre::Real(bounds.top() + bounds.height()) / aWindowSize.height();
+		
+		mUserInterfaceScreen->setCorners(uLeft * 2 - 1, 1 - vTop * 2, uRight * 2 - 1, 1 - vBottom * 2);
+		mUserInterfaceScreen->setUVs(Ogre::Vector2(uLeft, vTop), Ogre::Vector2(uLeft, vBottom),
+				Ogre::Vector2(uRight, vTop), Ogre::Vector2(uRight, vBottom));
+		mUserInterfaceScreen->setVisible(true);
+	}
 }
@@ -41,6 +41,32 @@ int main(int argc, char *argv[])
 	{
 		//Run the game
 		corePtr.reset(new Cutexture::Core());
+		
+		// --record <file>, --replay <file>, --replay-fast <file>, --frames <count>
+		const QStringList arguments = app.arguments();
+		for (int i = 1; i + 1 < arguments.size(); i += 2)
+		{
+			const QString &option = arguments.at(i);
+			const QString &value = arguments.at(i + 1);
+			
+			if (option == "--record")
+			{
+				corePtr->setInputRecordingFile(value);
+			}
+			else if (option == "--replay")
+			{
+				corePtr->setInputReplayFile(value, true);
+			}
+			else if (option == "--replay-fast")
+			{
+				corePtr->setInputReplayFile(value, false);
+			}
+			else if (option == "--frames")
+			{
+				corePtr->setFrameLimit(value.toUInt());
+			}
+		}
+		
 		// blocking call; we advance Qt's event loop in this method; no need to call app.exec()
 		corePtr->go();
 		
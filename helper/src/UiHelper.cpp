@@ -0,0 +1,85 @@
+/** This file is part of Cutexture.
+ 
+ Copyright (c) 2010 Markus Weiland, Kevin Lang
+
+ Portions of this code may be under copyright of authors listed in AUTHORS.
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+#include "UiManager.h"
+#include "RemoteUiServer.h"
+
+#include <QWebView>
+#include <iostream>
+
+using namespace Cutexture;
+
+/** Runs a UI for a game using UiManager with 
+ * Enums::UiBackendRemoteProcess. 
+ * Usage: ui-helper <server name> <ui file> [web page url] */
+int main(int argc, char *argv[])
+{
+	QApplication app(argc, argv);
+
+	if (app.arguments().size() < 3)
+	{
+		std::cerr << "Usage: ui-helper <server name> <ui file> [web page url]" << std::endl;
+		return 1;
+	}
+
+	QFile file(app.arguments().at(2));
+	if (!file.open(QFile::ReadOnly))
+	{
+		std::cerr << "Cannot open " << file.fileName().toStdString() << std::endl;
+		return 1;
+	}
+
+	QUiLoader loader;
+	QWidget *ui = loader.load(&file);
+	file.close();
+
+	if (!ui)
+	{
+		std::cerr << "Cannot load " << file.fileName().toStdString() << std::endl;
+		return 1;
+	}
+
+	ui->setAttribute(Qt::WA_TranslucentBackground);
+
+	if (app.arguments().size() > 3 && ui->layout())
+	{
+		QWebView *web = new QWebView();
+		web->load(QUrl(app.arguments().at(3)));
+		ui->layout()->addWidget(web);
+	}
+
+	UiManager uiManager;
+	uiManager.setActiveWidget(ui);
+
+	RemoteUiServer server(&uiManager);
+	if (!server.connectToHost(app.arguments().at(1)))
+	{
+		std::cerr << "Cannot connect to " << app.arguments().at(1).toStdString() << std::endl;
+		return 1;
+	}
+
+	// quits when the game disconnects
+	return app.exec();
+}
@@ -0,0 +1,59 @@
+/** This file is part of Cutexture.
+ 
+ Copyright (c) 2010 Markus Weiland, Kevin Lang
+
+ Portions of this code may be under copyright of authors listed in AUTHORS.
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "Prerequisites.h"
+
+namespace Cutexture
+{
+	namespace Utility
+	{
+		/** A block-compressed image. */
+		struct CompressedImage
+		{
+			/** Ogre::PF_DXT1 (BC1) or Ogre::PF_DXT5 (BC3); 
+			 * Ogre::PF_UNKNOWN if the image is empty. */
+			Ogre::PixelFormat format;
+			QSize size;
+			QByteArray data;
+			
+			CompressedImage() :
+				format(Ogre::PF_UNKNOWN)
+			{
+			}
+		};
+		
+		/** Encodes aImage to BC1 if it is fully opaque and to BC3 
+		 * otherwise. The encoder favours speed over quality (bounding 
+		 * box endpoints, nearest palette entry) since it runs whenever 
+		 * a static UI changed. Safe to call from worker threads.
+		 * @param aImage An image of format QImage::Format_ARGB32. 
+		 * @param aSize Size of the result, at least the size of aImage. 
+		 * aImage is placed at the top left; the blocks outside of it 
+		 * are transparent black and are neither inspected nor encoded. */
+		CompressedImage compressImage(const QImage &aImage, const QSize &aSize);
+	}
+}
@@ -0,0 +1,70 @@
+/** This file is part of Cutexture.
+ 
+ Copyright (c) 2010 Markus Weiland, Kevin Lang
+
+ Portions of this code may be under copyright of authors listed in AUTHORS.
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "Prerequisites.h"
+#include "Enums.h"
+
+namespace Cutexture
+{
+	/** Proxy item for widgets in the UI scene which supports the 
+	 * cache modes in Enums::WidgetCacheMode. Proxies for child 
+	 * widgets created with createProxyForChildWidget() are 
+	 * CachedProxyWidgets as well. A child widget with its own proxy 
+	 * is not painted by its parent's proxy, so its subtree is 
+	 * composed from its own cache.
+	 */
+	class CachedProxyWidget: public QGraphicsProxyWidget
+	{
+	public:
+		CachedProxyWidget(QGraphicsItem *aParent = NULL);
+		virtual ~CachedProxyWidget();
+		
+		void setWidgetCacheMode(Enums::WidgetCacheMode aMode);
+		inline Enums::WidgetCacheMode getWidgetCacheMode() const { return mWidgetCacheMode; }
+		
+		/** Discards the cached contents so that the widget is 
+		 * repainted the next time it is exposed. */
+		void invalidateCache();
+		
+		void paint(QPainter *aPainter, const QStyleOptionGraphicsItem *aOption, QWidget *aWidget);
+		
+	protected:
+		/** Invalidates a recorded picture on events which change 
+		 * the appearance of the embedded widget without an update 
+		 * that could be observed. */
+		bool eventFilter(QObject *aObject, QEvent *aEvent);
+		
+		QGraphicsProxyWidget* newProxyWidget(const QWidget *aChild);
+		
+	private:
+		Enums::WidgetCacheMode mWidgetCacheMode;
+		
+		/** Recorded paint commands in picture mode. */
+		QPicture mPicture;
+		bool mPictureValid;
+	};
+}
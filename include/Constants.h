@@ -26,6 +26,7 @@
 #pragma once
 
 #include <OgreString.h>
+#include <QtCore/QtGlobal>
 
 namespace Cutexture
 {
@@ -33,7 +34,71 @@ namespace Cutexture
 	 * cross-referencing between components. */
 	namespace Constants
 	{
-		static const int INPUT_MANAGER_MOUSE_OFFSET_X = 6;
-		static const int INPUT_MANAGER_MOUSE_OFFSET_Y = 6;
+		/** Edge length in pixels of the texture of the cursor 
+		 * layer. Cursor images are clipped to it. */
+		static const int CURSOR_TEXTURE_SIZE = 64;
+		
+		/** Default edge length in pixels of the tiles compared by 
+		 * UiManager's tile diffing. */
+		static const int UI_TILE_SIZE = 64;
+		
+		/** Minimum height in pixels of a band rasterized by one 
+		 * thread when UiManager renders in parallel. */
+		static const int UI_MIN_RENDER_BAND_HEIGHT = 32;
+		
+		/** Key of the QGraphicsItem data which marks an item as 
+		 * safe to paint from worker threads. 
+		 * @see UiManager::setThreadSafePainting() */
+		static const int UI_THREAD_SAFE_PAINT_DATA_KEY = 0x43545450;
+		
+		/** Time in milliseconds a static UI has to stay unchanged 
+		 * before it is block-compressed. */
+		static const int UI_STATIC_ENCODE_DELAY = 500;
+		
+		/** Suffix of the name of the block-compressed copy of the 
+		 * UI texture. */
+		static const char UI_COMPRESSED_TEXTURE_SUFFIX[] = "/Compressed";
+		
+		/** Name of the dynamic widget property which selects the 
+		 * cache mode of a widget, e.g. set in a .ui file. Values 
+		 * are "none", "pixmap" and "picture". */
+		static const char UI_CACHE_MODE_PROPERTY[] = "cutextureCacheMode";
+		
+		/** Default limit in bytes of the estimated memory used by 
+		 * the hidden screens pooled by ScreenRegistry. */
+		static const qint64 UI_SCREEN_POOL_MAX_COST = 32 * 1024 * 1024;
+		
+		/** Estimated memory in bytes used by a widget on top of 
+		 * its pixels. */
+		static const qint64 UI_SCREEN_WIDGET_COST = 1024;
+		
+		/** Identifies a ResourcePack file ("CTXP"). */
+		static const quint32 RESOURCE_PACK_MAGIC = 0x50585443;
+		
+		static const quint32 RESOURCE_PACK_VERSION = 1;
+		
+		/** Size in bytes of the header at the start of a 
+		 * ResourcePack file. */
+		static const int RESOURCE_PACK_HEADER_SIZE = 32;
+		
+		/** Alignment in bytes of uncompressed ResourcePack entries, 
+		 * so that they start on a page of the mapped file. */
+		static const qint64 RESOURCE_PACK_ALIGNMENT = 4096;
+		
+		/** Archive type to use for ResourcePack files in Ogre's 
+		 * resources.cfg. */
+		static const Ogre::String RESOURCE_PACK_ARCHIVE_TYPE = "CutexturePack";
+		
+		/** Number of frames in the shared memory between the game 
+		 * and the UI helper process. */
+		static const int REMOTE_UI_FRAME_SLOTS = 3;
+		
+		/** Interval in milliseconds at which the UI helper process 
+		 * checks for UI changes. */
+		static const int REMOTE_UI_RENDER_INTERVAL = 4;
+		
+		/** Time in milliseconds to wait for the UI helper process 
+		 * to connect. */
+		static const int REMOTE_UI_CONNECT_TIMEOUT = 5000;
 	}
 }
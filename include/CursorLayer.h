@@ -0,0 +1,107 @@
+/** This file is part of Cutexture.
+ 
+ Copyright (c) 2010 Markus Weiland, Kevin Lang
+
+ Portions of this code may be under copyright of authors listed in AUTHORS.
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "Prerequisites.h"
+
+namespace Cutexture
+{
+	/** Draws the mouse cursor on its own small texture and overlay 
+	 * quad above the UI. Moving the cursor only moves the quad, so 
+	 * pointer motion neither repaints nor uploads the UI texture and 
+	 * the cursor follows the mouse at full frame rate even when the 
+	 * UI is updated less often. 
+	 * Cursor shapes are mapped to images; shapes without an image 
+	 * are shown with the arrow image.
+	 */
+	class CursorLayer
+	{
+	public:
+		/** Creates the quad, material and texture named after aName 
+		 * in aSceneManager. */
+		CursorLayer(Ogre::SceneManager *aSceneManager, const Ogre::String &aName);
+		virtual ~CursorLayer();
+
+		/** Sets the image shown for aShape. aHotSpot is the pixel of 
+		 * aImage which is placed at the mouse position. Images are 
+		 * clipped to Constants::CURSOR_TEXTURE_SIZE. Replaces the 
+		 * built-in image for the arrow, I-beam, cross and resize 
+		 * shapes. */
+		void setCursorImage(Qt::CursorShape aShape, const QImage &aImage, const QPoint &aHotSpot);
+
+		/** Shows aCursor. Only uploads to the texture if the shape 
+		 * differs from the current one. Bitmap cursors are shown 
+		 * with their own pixmap, Qt::BlankCursor hides the layer. */
+		void setCursor(const QCursor &aCursor);
+
+		/** Moves the hot spot of the cursor to aPosition in window 
+		 * coordinates. Only changes the quad corners. */
+		void setPosition(const QPoint &aPosition, const QSize &aWindowSize);
+
+		/** Shows or hides the cursor, e.g. while the camera is 
+		 * controlled with the mouse. */
+		void setVisible(bool aVisible);
+		inline bool isVisible() const { return mVisible; }
+
+	private:
+		struct CursorImage
+		{
+			QImage image;
+			QPoint hotSpot;
+		};
+
+		Ogre::SceneManager *mSceneManager;
+		Ogre::Rectangle2D *mQuad;
+		Ogre::SceneNode *mNode;
+		Ogre::MaterialPtr mMaterial;
+		Ogre::TexturePtr mTexture;
+
+		/** Images by Qt::CursorShape. */
+		QHash<int, CursorImage> mCursorImages;
+
+		/** Shape currently in the texture or -1 if none. */
+		int mCurrentShape;
+		/** Cache key of the pixmap currently in the texture if the 
+		 * shape is Qt::BitmapCursor. */
+		qint64 mCurrentPixmapKey;
+		/** Hot spot of the image currently in the texture. */
+		QPoint mHotSpot;
+
+		QPoint mPosition;
+		QSize mWindowSize;
+		bool mVisible;
+		bool mBlank;
+
+		/** Copies aImage into the top left corner of the texture 
+		 * and clears the rest. */
+		void upload(const QImage &aImage);
+		void updateQuad();
+		void updateVisibility();
+
+		/** @return The built-in image for aShape or a null image. */
+		static QImage createDefaultImage(Qt::CursorShape aShape, QPoint &aHotSpot);
+	};
+}
@@ -0,0 +1,110 @@
+/** This file is part of Cutexture.
+ 
+ Copyright (c) 2010 Markus Weiland, Kevin Lang
+
+ Portions of this code may be under copyright of authors listed in AUTHORS.
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "Prerequisites.h"
+
+namespace Cutexture
+{
+	/** Binds game values, e.g. health or ammo, to properties of 
+	 * named widgets, as loaded from .ui files. A value is only 
+	 * written to its widget if it differs from the value written 
+	 * last, so a HUD which is updated every frame only repaints 
+	 * when something actually changed. Must be used from the GUI 
+	 * thread; game threads use UiCommandQueue instead.
+	 */
+	class DataBinder
+	{
+	public:
+		DataBinder();
+		virtual ~DataBinder();
+
+		/** Sets the object below which bound objects are looked up 
+		 * by name. Values are written to the widgets of the new root 
+		 * on the next update. */
+		void setRoot(QObject *aRoot);
+
+		inline QObject* getRoot() const { return mRoot; }
+
+		/** Binds the value aKey to the property aProperty of the 
+		 * object named aObjectName, e.g. 
+		 * bind("health", "healthBar", "value"). Replaces an 
+		 * existing binding of aKey. */
+		void bind(const QString &aKey, const QString &aObjectName, const char *aProperty);
+
+		void unbind(const QString &aKey);
+
+		/** Starts a transaction. Values set until the matching 
+		 * commit() are written together. Transactions can be 
+		 * nested. */
+		void begin();
+
+		/** Ends a transaction. Once the outermost transaction ends, 
+		 * writes the values which changed.
+		 * @return The number of written properties. */
+		int commit();
+
+		inline bool isInTransaction() const { return (mTransactionDepth > 0); }
+
+		/** Sets the value bound to aKey. Outside a transaction, it 
+		 * is written immediately if it changed. */
+		void setValue(const QString &aKey, const QVariant &aValue);
+
+		/** @return The value last set for aKey. */
+		QVariant getValue(const QString &aKey) const;
+
+	private:
+		struct Binding
+		{
+			QString objectName;
+			QByteArray property;
+
+			/** Resolved lazily; null if not yet found. */
+			QPointer<QObject> target;
+
+			/** Value last written to target. */
+			QVariant appliedValue;
+
+			QVariant value;
+			bool changed;
+		};
+
+		QPointer<QObject> mRoot;
+		QHash<QString, Binding> mBindings;
+
+		int mTransactionDepth;
+
+		/** True if a value changed during the current 
+		 * transaction. */
+		bool mPendingChanges;
+
+		/** Writes all changed values. @return Number of writes. */
+		int applyChanges();
+
+		/** @return True if the value was written. */
+		bool applyBinding(Binding &aBinding);
+	};
+}
@@ -49,5 +49,61 @@ namespace Cutexture
 		};
 		Q_DECLARE_FLAGS	(Movements, Movement)
 		Q_DECLARE_OPERATORS_FOR_FLAGS(Movements)
+		
+		/** Pixel formats of the UI texture. Formats other than 
+		 * TextureFormatARGB8888 trade colour depth for upload 
+		 * bandwidth. */
+		enum TextureFormat
+		{
+			/** 32 bits per pixel, no conversion. */
+			TextureFormatARGB8888,
+			/** 16 bits per pixel, 4 bits per channel. */
+			TextureFormatARGB4444,
+			/** 16 bits per pixel, 5 bits per colour channel and 
+			 * 1 bit alpha mask. */
+			TextureFormatARGB1555,
+			/** 8 bits per pixel alpha only; the colour is a single 
+			 * tint colour. For monochrome HUDs. */
+			TextureFormatAlpha8
+		};
+		
+		/** How a widget subtree of the UI is cached. 
+		 * @see UiManager::setWidgetCacheMode() */
+		enum WidgetCacheMode
+		{
+			/** Repainted whenever it is exposed. */
+			WidgetCacheNone,
+			/** Cached in a device coordinate pixmap which is 
+			 * invalidated whenever the subtree updates. */
+			WidgetCachePixmap,
+			/** Recorded once into a QPicture which is replayed 
+			 * until the cache is invalidated. For vector-heavy 
+			 * panels whose contents rarely change. */
+			WidgetCachePicture
+		};
+		
+		/** How UiManager embeds and renders the UI. */
+		enum UiBackend
+		{
+			/** The active widget is embedded in a QGraphicsScene 
+			 * through a QGraphicsProxyWidget and rendered by a 
+			 * hidden QGraphicsView. Supports widget cache modes, 
+			 * parallel rendering of plain items and popups. */
+			UiBackendGraphicsView,
+			/** The active widget is rendered directly with 
+			 * QWidget::render() and input events are sent straight 
+			 * to the widget under the cursor or with focus. Avoids 
+			 * the proxy overhead, but popup windows (e.g. of combo 
+			 * boxes) are not part of the UI texture. */
+			UiBackendDirectWidget,
+			/** The UI runs in a helper process which renders it 
+			 * into shared memory (see RemoteUiServer). UiManager 
+			 * only uploads the changed parts and forwards input. 
+			 * Qt's layout and painting costs leave the game 
+			 * process and a crash of the UI does not take the game 
+			 * down. The virtual resolution and render scale of the 
+			 * game's UiManager are not applied. */
+			UiBackendRemoteProcess
+		};
 	}
 }
@@ -0,0 +1,57 @@
+/** This file is part of Cutexture.
+ 
+ Copyright (c) 2010 Markus Weiland, Kevin Lang
+
+ Portions of this code may be under copyright of authors listed in AUTHORS.
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "Prerequisites.h"
+
+#if QT_VERSION >= 0x040800
+
+namespace Cutexture
+{
+	/** Replaces the timer which advances Qt's animations, so 
+	 * that all animations advance exactly once per rendered frame 
+	 * when UiManager::advanceFrame() calls advance(). Qt 4.8 still 
+	 * computes the animation time from its own clock, so the 
+	 * steps follow the frames but not the frame timestamps. 
+	 * @see UiManager::setFrameClock()
+	 */
+	class FrameAnimationDriver: public QAnimationDriver
+	{
+	public:
+		FrameAnimationDriver(QObject *aParent = NULL);
+		virtual ~FrameAnimationDriver();
+
+	protected:
+		/** Called by Qt when the first animation starts. Unlike 
+		 * Qt's default driver, no timer is started. */
+		void started();
+
+		/** Called by Qt when the last animation stopped. */
+		void stopped();
+	};
+}
+
+#endif
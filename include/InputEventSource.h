@@ -0,0 +1,61 @@
+/** This file is part of Cutexture.
+ 
+ Copyright (c) 2010 Markus Weiland, Kevin Lang
+
+ Portions of this code may be under copyright of authors listed in AUTHORS.
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "Prerequisites.h"
+
+namespace Cutexture
+{
+	/** Provider of OIS-level mouse and keyboard events for the
+	 * InputManager. The default source reads real OIS devices
+	 * (@see OisInputSource), but any other source, e.g. one that
+	 * generates synthetic events, can be plugged in instead.
+	 */
+	class InputEventSource
+	{
+	public:
+		virtual ~InputEventSource()
+		{
+		}
+
+		/** Sets the listeners which receive the events of this
+		 * source during capture(). */
+		virtual void setEventCallbacks(OIS::MouseListener *aMouseListener,
+				OIS::KeyListener *aKeyListener) = 0;
+
+		/** Delivers all events that occurred since the last call to
+		 * the listeners set through setEventCallbacks(). */
+		virtual void capture() = 0;
+
+		/** @return The current mouse state. The relative axis values
+		 * hold the movement since the previous capture(). */
+		virtual const OIS::MouseState &getMouseState() const = 0;
+
+		/** Sets the area to which absolute mouse coordinates are
+		 * clipped. */
+		virtual void setMouseArea(int aWidth, int aHeight) = 0;
+	};
+}
@@ -27,6 +27,8 @@
 
 #include "Prerequisites.h"
 #include "Enums.h"
+#include "InputEventSource.h"
+#include "InputRecorder.h"
 
 namespace Cutexture
 {
@@ -35,6 +37,8 @@ namespace Cutexture
 	 * converts them to Qt mouse and keyboard events. Also separates 
 	 * one-time input events (e.g. mouse button clicked) from continuous 
 	 * input (e.g. camera movement key is pressed).
+	 * The OIS events are read from an InputEventSource, which by default 
+	 * wraps the devices of a render window.
 	 */
 	class InputManager: public QObject,
 			public OIS::MouseListener,
@@ -45,18 +49,46 @@ namespace Cutexture
 		InputManager();
 		virtual ~InputManager();
 
-		void initialize(Ogre::RenderWindow *aRenderWindow);
-		inline bool isInitialized() const { return (mOis && mOisKeyboard && mOisMouse); }
+		/** Reads input from the OIS devices of aRenderWindow. 
+		 * @param aHideSystemCursor Hides the system cursor over 
+		 * the window, e.g. if a CursorLayer draws the cursor. */
+		void initialize(Ogre::RenderWindow *aRenderWindow, bool aHideSystemCursor = false);
+		/** Reads input from aEventSource. Takes ownership of 
+		 * aEventSource. */
+		void initialize(InputEventSource *aEventSource);
+		inline bool isInitialized() const { return (mEventSource != NULL); }
+
+		/** @return The source of OIS events or null if not 
+		 * initialized. */
+		inline InputEventSource* getEventSource() const { return mEventSource; }
 
 		/** Updates the current input state and stores the Qt 
 		 * keyboard and mouse events in a buffer. 
 		 * @see emitInputEvents() */
 		void updateInputState();
 
+		/** Starts writing all OIS events received from the event 
+		 * source to aFileName, grouped by frame. A frame ends 
+		 * with each call to updateInputState(). Throws if the 
+		 * file cannot be opened.
+		 * @see ReplayInputSource */
+		void startRecording(const QString &aFileName);
+
+		/** Stops a recording started with startRecording() and 
+		 * closes the file. */
+		void stopRecording();
+
+		/** @return True if input events are being recorded. */
+		inline bool isRecording() const { return (mInputRecorder != NULL); }
+
 		/** Call to update the input manager based on the new
 		 window size. */
 		void resizeEvent(QResizeEvent *event);
 
+		/** Returns the mouse position in window coordinates as of 
+		 * the last update. */
+		QPoint getMousePosition() const;
+
 		/** Returns the relative mouse movement since the last update. */
 		QPoint getRelativeMouseMovement() const;
 
@@ -68,6 +100,11 @@ namespace Cutexture
 		inline Qt::MouseButtons getMouseButtonsPressed() const
 			{ return mMouseButtonsPressed; }
 		
+		/** @return True if input events have accumulated since 
+		 * the last call to emitInputEvents(). */
+		inline bool hasPendingInputEvents() const
+			{ return !mInputEvents.isEmpty(); }
+		
 		/** Emits all input events which have accumulated 
 		 * since the last time this method was called. */
 		void emitInputEvents();
@@ -88,12 +125,12 @@ namespace Cutexture
 		bool keyReleased(const OIS::KeyEvent &arg);
 
 	private:
-		/** Pointer to the OpenInputSystem input manager. */
-		OIS::InputManager *mOis;
-		/** OpenInputSystem keyboard handler. */
-		OIS::Keyboard *mOisKeyboard;
-		/** OpenInputSystem mouse handler. */
-		OIS::Mouse *mOisMouse;
+		/** Source of OIS keyboard and mouse events. Owned by us. */
+		InputEventSource *mEventSource;
+
+		/** Writes received OIS events to a file while recording. 
+		 * Null if not recording. Owned by us. */
+		InputRecorder *mInputRecorder;
 
 		/** Bitflag of currently pressed mouse buttons. */
 		Qt::MouseButtons mMouseButtonsPressed;
@@ -0,0 +1,65 @@
+/** This file is part of Cutexture.
+ 
+ Copyright (c) 2010 Markus Weiland, Kevin Lang
+
+ Portions of this code may be under copyright of authors listed in AUTHORS.
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "InputRecording.h"
+
+namespace Cutexture
+{
+	/** Writes the stream of OIS-level input events to a compact
+	 * binary file which can be replayed with ReplayInputSource.
+	 * @see InputRecording for the file format. */
+	class InputRecorder
+	{
+	public:
+		/** Opens aFileName for writing and writes the file header.
+		 * Throws if the file cannot be opened. */
+		InputRecorder(const QString &aFileName);
+		virtual ~InputRecorder();
+
+		void recordMouseEvent(InputRecording::RecordType aType, const OIS::MouseEvent &aEvent,
+				OIS::MouseButtonID aButton = OIS::MB_Left);
+		void recordKeyEvent(InputRecording::RecordType aType, const OIS::KeyEvent &aEvent);
+
+		/** Closes the current frame. All events recorded since the
+		 * previous call belong to this frame.
+		 * @param aMouseState Mouse state at the end of the frame. */
+		void recordFrame(const OIS::MouseState &aMouseState);
+
+		/** @return The number of frames recorded so far. */
+		inline quint32 getFrameCount() const { return mFrameIndex; }
+
+	private:
+		QFile mFile;
+		QDataStream mStream;
+
+		/** Index of the frame currently being recorded. */
+		quint32 mFrameIndex;
+
+		/** Time since the first frame was recorded. */
+		QTime mRecordingTime;
+	};
+}
@@ -0,0 +1,89 @@
+/** This file is part of Cutexture.
+ 
+ Copyright (c) 2010 Markus Weiland, Kevin Lang
+
+ Portions of this code may be under copyright of authors listed in AUTHORS.
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "Prerequisites.h"
+
+namespace Cutexture
+{
+	/** Binary layout of input recordings written by InputRecorder
+	 * and read by ReplayInputSource.
+	 *
+	 * A recording starts with MAGIC and VERSION, followed by a
+	 * sequence of records. Each record starts with a quint8
+	 * RecordType. Mouse records store the OIS mouse state (absolute
+	 * and relative axes as qint16/qint32, buttons as quint8) and the
+	 * button ID; key records store the OIS key code (quint8) and the
+	 * unicode text (quint32). The events of one frame are followed
+	 * by a Frame record containing the frame index, the time in 
+	 * milliseconds since the end of the first recorded frame (so 
+	 * the first Frame record is always 0) and the mouse state at 
+	 * the end of the frame. All values are big endian. */
+	namespace InputRecording
+	{
+		static const quint32 MAGIC = 0x43544952; // "CTIR"
+		static const quint16 VERSION = 1;
+
+		enum RecordType
+		{
+			MouseMoved = 1,
+			MousePressed = 2,
+			MouseReleased = 3,
+			KeyPressed = 4,
+			KeyReleased = 5,
+			Frame = 6
+		};
+
+		/** Size in bytes of a serialized mouse state. */
+		static const int MOUSE_STATE_SIZE = 17;
+		/** Size in bytes of mouse and key records after the type. */
+		static const int MOUSE_RECORD_SIZE = MOUSE_STATE_SIZE + 1;
+		static const int KEY_RECORD_SIZE = 5;
+
+		inline void writeMouseState(QDataStream &aStream, const OIS::MouseState &aState)
+		{
+			aStream << qint16(aState.X.abs) << qint16(aState.Y.abs) << qint32(aState.Z.abs)
+					<< qint16(aState.X.rel) << qint16(aState.Y.rel) << qint32(aState.Z.rel)
+					<< quint8(aState.buttons);
+		}
+
+		inline void readMouseState(QDataStream &aStream, OIS::MouseState &aState)
+		{
+			qint16 absX, absY, relX, relY;
+			qint32 absZ, relZ;
+			quint8 buttons;
+			aStream >> absX >> absY >> absZ >> relX >> relY >> relZ >> buttons;
+
+			aState.X.abs = absX;
+			aState.Y.abs = absY;
+			aState.Z.abs = absZ;
+			aState.X.rel = relX;
+			aState.Y.rel = relY;
+			aState.Z.rel = relZ;
+			aState.buttons = buttons;
+		}
+	}
+}
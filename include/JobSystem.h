@@ -0,0 +1,246 @@
+/** This file is part of Cutexture.
+ 
+ Copyright (c) 2010 Markus Weiland, Kevin Lang
+
+ Portions of this code may be under copyright of authors listed in AUTHORS.
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "Prerequisites.h"
+
+namespace Cutexture
+{
+	class JobGraph;
+
+	/** A unit of work of a JobGraph. */
+	class Job
+	{
+	public:
+		virtual ~Job()
+		{
+		}
+
+		/** Does the work. May run on any thread unless the job was 
+		 * added with JobSystem::MainThread affinity. Throwing 
+		 * cancels the jobs of the graph which have not started yet. */
+		virtual void run() = 0;
+	};
+
+	/** Calls a method without arguments of an object. */
+	template<class T>
+	class MethodJob: public Job
+	{
+	public:
+		MethodJob(T *aObject, void (T::*aMethod)()) :
+			mObject(aObject), mMethod(aMethod)
+		{
+			assert(aObject && aMethod);
+		}
+
+		void run()
+		{
+			(mObject->*mMethod)();
+		}
+
+	private:
+		T *mObject;
+		void (T::*mMethod)();
+	};
+
+	/** Work-stealing scheduler for graphs of jobs. 
+	 * 
+	 * Each worker thread and the main thread own a queue. A thread 
+	 * takes the newest job of its own queue and, once that is 
+	 * empty, steals the oldest job of another queue, so that the 
+	 * jobs a finished job enables stay on the thread whose caches 
+	 * hold its data while idle threads take over whole branches of 
+	 * the graph. Jobs with MainThread affinity, i.e. anything that 
+	 * calls Qt widgets or the render system, only run on the thread 
+	 * that calls run(). 
+	 * 
+	 * The main thread works on the graph as well while it waits, so 
+	 * a JobSystem without workers runs every graph on the main 
+	 * thread in dependency order.
+	 */
+	class JobSystem
+	{
+	public:
+		enum Affinity
+		{
+			/** The job may run on any worker or the main thread. */
+			AnyThread,
+			/** The job only runs on the thread that calls run(). */
+			MainThread
+		};
+
+		/** Starts the worker threads. 
+		 * @param aWorkerCount Number of worker threads; negative 
+		 * means one less than QThread::idealThreadCount(), leaving a 
+		 * core to the main thread. */
+		JobSystem(int aWorkerCount = -1);
+
+		/** Stops and joins the worker threads. */
+		virtual ~JobSystem();
+
+		/** Runs all jobs of aGraph and returns once they are 
+		 * finished. Must be called from the main thread, i.e. the 
+		 * thread which created the JobSystem, and never from a job.
+		 * Throws if a job throws, after the running jobs have 
+		 * finished. */
+		void run(JobGraph &aGraph);
+
+		inline int getWorkerCount() const
+		{
+			return mWorkers.size();
+		}
+
+		/** @return Number of jobs taken from the queue of another 
+		 * thread since the JobSystem was created. */
+		int getStealCount() const;
+
+	private:
+		Q_DISABLE_COPY(JobSystem)
+
+		class Worker;
+		friend class Worker;
+
+		struct Task
+		{
+			JobGraph *graph;
+			int job;
+		};
+
+		/** Queue of a thread; the owner works at the back, thieves 
+		 * at the front. */
+		struct TaskQueue
+		{
+			QMutex mutex;
+			QList<Task> tasks;
+		};
+
+		QList<Worker *> mWorkers;
+
+		/** One queue per worker followed by the one of the main 
+		 * thread. */
+		QList<TaskQueue *> mQueues;
+
+		/** Jobs with MainThread affinity which are ready to run. */
+		TaskQueue mMainThreadTasks;
+
+		/** Number of tasks in mQueues. */
+		QAtomicInt mQueuedTasks;
+		QAtomicInt mStealCount;
+
+		/** Guards sleeping and waking of all threads. */
+		QMutex mSleepMutex;
+		QWaitCondition mWorkAvailable;
+		bool mStopping;
+
+		QThread *mMainThread;
+
+		/** Index of the queue of the main thread in mQueues. */
+		inline int getMainQueue() const
+		{
+			return mWorkers.size();
+		}
+
+		/** Loop of the worker owning queue aQueue. */
+		void work(int aQueue);
+
+		/** Takes a task from queue aQueue or, failing that, steals 
+		 * one from another queue. */
+		bool takeTask(int aQueue, Task &aTask);
+
+		/** Queues aTask on queue aQueue or on the main thread, 
+		 * depending on its affinity, and wakes a thread to run it. */
+		void pushTask(int aQueue, const Task &aTask);
+
+		/** Runs aTask on the thread owning queue aQueue and queues 
+		 * the jobs this enables. */
+		void execute(int aQueue, const Task &aTask);
+	};
+
+	/** Jobs and their dependencies, e.g. the work of one frame. A 
+	 * graph is built once and may be run any number of times, but 
+	 * must not be changed while it runs. */
+	class JobGraph
+	{
+	public:
+		JobGraph();
+
+		/** Deletes the jobs. */
+		virtual ~JobGraph();
+
+		/** Adds aJob, which the graph takes ownership of. 
+		 * @param aDependencies Ids of the jobs which must finish 
+		 * before this one starts. Only jobs added before can be 
+		 * dependencies, so graphs never contain cycles. 
+		 * @return The id of the job. */
+		int addJob(Job *aJob, const QList<int> &aDependencies = QList<int> (),
+				JobSystem::Affinity aAffinity = JobSystem::AnyThread);
+
+		/** Adds a job which calls aMethod of aObject, e.g. 
+		 * addJob(this, &Core::simulate). */
+		template<class T>
+		int addJob(T *aObject, void (T::*aMethod)(), const QList<int> &aDependencies =
+				QList<int> (), JobSystem::Affinity aAffinity = JobSystem::AnyThread)
+		{
+			return addJob(new MethodJob<T> (aObject, aMethod), aDependencies, aAffinity);
+		}
+
+		/** Deletes all jobs. */
+		void clear();
+
+		inline int getJobCount() const
+		{
+			return mNodes.size();
+		}
+
+	private:
+		Q_DISABLE_COPY(JobGraph)
+
+		friend class JobSystem;
+
+		struct Node
+		{
+			Job *job;
+			JobSystem::Affinity affinity;
+			QVector<int> successors;
+			int dependencyCount;
+
+			/** Dependencies which have not finished in this run. */
+			QAtomicInt pendingDependencies;
+		};
+
+		QVector<Node *> mNodes;
+
+		/** Jobs which have not finished in this run. */
+		QAtomicInt mPendingJobs;
+
+		/** Guards mError. */
+		QMutex mErrorMutex;
+
+		/** Set if a job threw in this run. */
+		QString mError;
+		QAtomicInt mFailed;
+	};
+}
@@ -0,0 +1,62 @@
+/** This file is part of Cutexture.
+ 
+ Copyright (c) 2010 Markus Weiland, Kevin Lang
+
+ Portions of this code may be under copyright of authors listed in AUTHORS.
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "InputEventSource.h"
+
+namespace Cutexture
+{
+	/** Input event source which reads the keyboard and mouse
+	 * attached to an Ogre render window through OIS (Open Input
+	 * System). */
+	class OisInputSource: public InputEventSource
+	{
+	public:
+		OisInputSource();
+		virtual ~OisInputSource();
+
+		/** Creates the OIS keyboard and mouse devices for the window
+		 * aRenderWindow.
+		 * @param aHideSystemCursor Hides the system cursor while it 
+		 * is over the window. */
+		void initialize(Ogre::RenderWindow *aRenderWindow, bool aHideSystemCursor = false);
+
+		void setEventCallbacks(OIS::MouseListener *aMouseListener, OIS::KeyListener *aKeyListener);
+		void capture();
+		const OIS::MouseState &getMouseState() const;
+		void setMouseArea(int aWidth, int aHeight);
+
+	private:
+		/** Pointer to the OpenInputSystem input manager. */
+		OIS::InputManager *mOis;
+		/** OpenInputSystem keyboard handler. */
+		OIS::Keyboard *mOisKeyboard;
+		/** OpenInputSystem mouse handler. */
+		OIS::Mouse *mOisMouse;
+		/** True if initialize() hid the system cursor. */
+		bool mSystemCursorHidden;
+	};
+}
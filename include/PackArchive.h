@@ -0,0 +1,82 @@
+/** This file is part of Cutexture.
+ 
+ Copyright (c) 2010 Markus Weiland, Kevin Lang
+
+ Portions of this code may be under copyright of authors listed in AUTHORS.
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "Prerequisites.h"
+#include "ResourcePack.h"
+
+namespace Cutexture
+{
+	/** Ogre archive which reads resources from a ResourcePack. 
+	 * Uncompressed entries are handed to Ogre as streams over the 
+	 * mapped file, without a copy. Register a PackArchiveFactory 
+	 * and list packs in resources.cfg with the type 
+	 * Constants::RESOURCE_PACK_ARCHIVE_TYPE.
+	 */
+	class PackArchive: public Ogre::Archive
+	{
+	public:
+		PackArchive(const Ogre::String &aName, const Ogre::String &aArchiveType);
+		virtual ~PackArchive();
+
+		/** @see Ogre::Archive */
+		bool isCaseSensitive() const;
+		void load();
+		void unload();
+		Ogre::DataStreamPtr open(const Ogre::String &aFileName, bool aReadOnly = true) const;
+		Ogre::StringVectorPtr list(bool aRecursive = true, bool aDirs = false);
+		Ogre::FileInfoListPtr listFileInfo(bool aRecursive = true, bool aDirs = false);
+		Ogre::StringVectorPtr find(const Ogre::String &aPattern, bool aRecursive = true,
+				bool aDirs = false);
+		Ogre::FileInfoListPtr findFileInfo(const Ogre::String &aPattern, bool aRecursive = true,
+				bool aDirs = false) const;
+		bool exists(const Ogre::String &aFileName);
+		time_t getModifiedTime(const Ogre::String &aFileName);
+
+	private:
+		ResourcePack mPack;
+
+		/** @return Names of the entries matching aPattern. Patterns 
+		 * without a path are matched against the file names only. */
+		QStringList findEntries(const Ogre::String &aPattern, bool aRecursive) const;
+
+		Ogre::FileInfo getFileInfo(const QString &aEntry) const;
+	};
+
+	/** Creates PackArchive instances for Ogre's ArchiveManager. 
+	 * Must outlive Ogre::Root.
+	 */
+	class PackArchiveFactory: public Ogre::ArchiveFactory
+	{
+	public:
+		virtual ~PackArchiveFactory();
+
+		/** @see Ogre::ArchiveFactory */
+		const Ogre::String& getType() const;
+		Ogre::Archive* createInstance(const Ogre::String &aName);
+		void destroyInstance(Ogre::Archive *aArchive);
+	};
+}
@@ -0,0 +1,47 @@
+/** This file is part of Cutexture.
+ 
+ Copyright (c) 2010 Markus Weiland, Kevin Lang
+
+ Portions of this code may be under copyright of authors listed in AUTHORS.
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "Prerequisites.h"
+#include "Enums.h"
+
+namespace Cutexture
+{
+	namespace Utility
+	{
+		/** @return The Ogre pixel format which stores aFormat. */
+		Ogre::PixelFormat toOgrePixelFormat(Enums::TextureFormat aFormat);
+		
+		/** Converts the pixels of aSource inside aRect to aFormat. 
+		 * Uses SSE2 kernels where available.
+		 * @param aSource An image of format QImage::Format_ARGB32.
+		 * @param aTarget Receives the top left pixel of aRect.
+		 * @param aTargetBytesPerLine Distance in bytes between two 
+		 * rows in aTarget. */
+		void convertPixels(const QImage &aSource, const QRect &aRect, Enums::TextureFormat aFormat,
+				uchar *aTarget, int aTargetBytesPerLine);
+	}
+}
@@ -30,6 +30,9 @@
 #pragma warning(push, 0)
 #endif
 
+#include <OgreArchive.h>
+#include <OgreArchiveFactory.h>
+#include <OgreArchiveManager.h>
 #include <OgreAxisAlignedBox.h>
 #include <OgreCamera.h>
 #include <OgreCommon.h>
@@ -39,6 +42,7 @@
 #include <OgreDataStream.h>
 #include <OgreEntity.h>
 #include <OgreException.h>
+#include <OgreFrameListener.h>
 #include <OgreHardwareBuffer.h>
 #include <OgreHardwarePixelBuffer.h>
 #include <OgreImage.h>
@@ -50,11 +54,18 @@
 #include <OgreMovableObject.h>
 #include <OgrePixelFormat.h>
 #include <OgreQuaternion.h>
+#include <OgreRectangle2D.h>
 #include <OgreRenderable.h>
 #include <OgreRenderOperation.h>
 #include <OgreRenderQueue.h>
+#include <OgreRenderQueueListener.h>
+#include <OgreRenderSystem.h>
+#include <OgreRenderSystemCapabilities.h>
 #include <OgreRenderWindow.h>
+#include <OgreResourceBackgroundQueue.h>
+#include <OgreResourceGroupManager.h>
 #include <OgreRoot.h>
+#include <OgreSceneManager.h>
 #include <OgreSceneNode.h>
 #include <OgreSharedPtr.h>
 #include <OgreSingleton.h>
@@ -66,6 +77,7 @@
 #include <OgreVector3.h>
 #include <OgreViewport.h>
 #include <OgreWindowEventUtilities.h>
+#include <OgreWorkQueue.h>
 
 /*#include <FreeImage.h>*/
 
@@ -89,12 +101,32 @@
 
 namespace Cutexture
 {
+	class CachedProxyWidget;
 	class Core;
+	class CursorLayer;
+	class DataBinder;
+	class FrameAnimationDriver;
 	class Exception;
 	class InputManager;
+	class Job;
+	class JobGraph;
+	class JobSystem;
+	class RemoteUiClient;
+	class RemoteUiServer;
+	class ReplayInputSource;
+	class ResourceLoader;
+	class ResourcePack;
+	class ResourcePackWriter;
 	class OgreCore;
+	class PackArchive;
+	class PackArchiveFactory;
 	class SceneManager;
+	class ScreenRegistry;
 	class SleepThread;
+	class StartupPipeline;
+	class TileDiff;
+	class UiCommandQueue;
+	class UiManager;
 	class ViewManager;
 	class Game;
 	class Settings;
@@ -0,0 +1,127 @@
+/** This file is part of Cutexture.
+ 
+ Copyright (c) 2010 Markus Weiland, Kevin Lang
+
+ Portions of this code may be under copyright of authors listed in AUTHORS.
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "Prerequisites.h"
+#include "Enums.h"
+
+#include <QtNetwork/QLocalServer>
+#include <QtNetwork/QLocalSocket>
+
+namespace Cutexture
+{
+	/** Game side of a UI running in a helper process. Starts the 
+	 * helper, owns the shared memory the helper renders into, 
+	 * forwards input events and uploads finished frames. 
+	 * Used by UiManager with Enums::UiBackendRemoteProcess.
+	 * @see RemoteUiProtocol.h
+	 */
+	class RemoteUiClient: public QObject
+	{
+	Q_OBJECT
+	public:
+		RemoteUiClient(QObject *aParent = NULL);
+		virtual ~RemoteUiClient();
+
+		/** Starts aProgram and waits for it to connect. The name of 
+		 * the local server is passed as first argument, followed 
+		 * by aArguments; the program is expected to run a 
+		 * RemoteUiServer connected to it.
+		 * @return False if the helper did not connect within 
+		 * Constants::REMOTE_UI_CONNECT_TIMEOUT. */
+		bool start(const QString &aProgram, const QStringList &aArguments);
+
+		/** Disconnects and terminates the helper. */
+		void stop();
+
+		/** @return True while the helper is connected. */
+		bool isConnected() const;
+
+		/** Sets the UI size. Allocates new shared memory; frames of 
+		 * the previous size are discarded. */
+		void resize(const QSize &aSize);
+
+		void sendMouseEvent(const QMouseEvent *aEvent);
+		void sendKeyEvent(const QKeyEvent *aEvent);
+
+		/** @return True if a frame arrived since the last upload. */
+		inline bool hasFrame() const { return mPendingSlot >= 0; }
+
+		/** Copies the changed parts of the newest frame into the top 
+		 * left of aTexture, converted to aFormat, and releases the 
+		 * frame to the helper.
+		 * @return The number of uploaded pixels. */
+		int uploadFrame(const Ogre::TexturePtr &aTexture, Enums::TextureFormat aFormat);
+
+		/** @return The content bounds of the newest frame in window 
+		 * coordinates. */
+		inline QRect getContentBounds() const { return mContentBounds; }
+
+		/** @return The cursor shape of the widget under the mouse. */
+		inline Qt::CursorShape getCursorShape() const { return mCursorShape; }
+
+	signals:
+		/** Emitted when a new frame can be uploaded. */
+		void frameReady();
+
+		/** Emitted when the helper disconnected, e.g. because it 
+		 * crashed. */
+		void disconnected();
+
+	private slots:
+		void readMessages();
+		void socketDisconnected();
+
+	private:
+		QLocalServer *mServer;
+		QLocalSocket *mSocket;
+		QProcess *mProcess;
+		QSharedMemory *mSharedMemory;
+
+		/** Name of the local server the helper connects to; also 
+		 * the prefix of the shared memory keys. */
+		QString mServerName;
+
+		/** Size of the frames in mSharedMemory. */
+		QSize mSize;
+
+		/** Incremented with each resize; frames of other 
+		 * generations are ignored. */
+		quint32 mGeneration;
+
+		/** Slot of the newest frame not uploaded yet or -1. */
+		int mPendingSlot;
+
+		/** Rectangles which changed since the last upload. */
+		QVector<QRect> mPendingRects;
+
+		QRect mContentBounds;
+		Qt::CursorShape mCursorShape;
+
+		void send(const QByteArray &aMessage);
+		void releaseSlot(quint32 aGeneration, int aSlot);
+	};
+}
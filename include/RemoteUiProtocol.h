@@ -0,0 +1,90 @@
+/** This file is part of Cutexture.
+ 
+ Copyright (c) 2010 Markus Weiland, Kevin Lang
+
+ Portions of this code may be under copyright of authors listed in AUTHORS.
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "Prerequisites.h"
+
+namespace Cutexture
+{
+	/** Protocol between UiManager with Enums::UiBackendRemoteProcess 
+	 * (the host) and RemoteUiServer in the UI helper process. 
+	 * 
+	 * The host owns a shared memory segment holding 
+	 * Constants::REMOTE_UI_FRAME_SLOTS frames of the UI size. The 
+	 * helper renders complete frames into free slots and announces 
+	 * them together with the rectangles which changed since the 
+	 * previous frame. A slot belongs to the host from its 
+	 * announcement until the host releases it.
+	 * 
+	 * Messages are sent over a local socket as a quint32 length 
+	 * followed by a QDataStream with the quint8 message type and 
+	 * the arguments listed for each type.
+	 */
+	namespace RemoteUi
+	{
+		enum MessageType
+		{
+			/** Host to helper: QSize size, QString shared memory key, 
+			 * quint32 generation. The helper attaches to the new 
+			 * segment, resizes the UI and forgets all slots of 
+			 * older generations. */
+			MessageResize,
+			/** Host to helper: quint8 event type, QPoint position, 
+			 * quint32 button, quint32 buttons, quint32 modifiers. */
+			MessageMouseEvent,
+			/** Host to helper: quint8 event type, qint32 key, 
+			 * quint32 modifiers, QString text. */
+			MessageKeyEvent,
+			/** Host to helper: quint32 generation, quint8 slot. The 
+			 * host does not read the slot anymore. */
+			MessageFrameReleased,
+			/** Helper to host: quint32 generation, quint8 slot, 
+			 * QVector<QRect> changed rectangles, QRect content 
+			 * bounds. */
+			MessageFrameReady,
+			/** Helper to host: qint32 Qt::CursorShape of the widget 
+			 * under the mouse. */
+			MessageCursorChanged
+		};
+
+		/** @return The size in bytes of a shared memory segment 
+		 * for frames of size aSize. */
+		int getSharedMemorySize(const QSize &aSize);
+
+		/** @return An image of size aSize which uses the memory of 
+		 * slot aSlot in aData, the start of the shared memory 
+		 * segment. */
+		QImage getSlotImage(void *aData, const QSize &aSize, int aSlot);
+
+		/** Writes aMessage with its length to aDevice. */
+		void writeMessage(QIODevice *aDevice, const QByteArray &aMessage);
+
+		/** Reads the next message from aDevice if it has been 
+		 * received completely.
+		 * @return False if no complete message is available. */
+		bool readMessage(QIODevice *aDevice, QByteArray &aMessage);
+	}
+}
@@ -0,0 +1,84 @@
+/** This file is part of Cutexture.
+ 
+ Copyright (c) 2010 Markus Weiland, Kevin Lang
+
+ Portions of this code may be under copyright of authors listed in AUTHORS.
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "Prerequisites.h"
+#include "Constants.h"
+#include "TileDiff.h"
+
+#include <QtNetwork/QLocalSocket>
+
+namespace Cutexture
+{
+	/** Helper process side of a remote UI. Renders the UI of a 
+	 * UiManager into the shared memory of the game process, 
+	 * announces changed rectangles and feeds the input events 
+	 * received from the game into the UiManager. The process quits 
+	 * when the game disconnects.
+	 * @see RemoteUiClient
+	 */
+	class RemoteUiServer: public QObject
+	{
+	Q_OBJECT
+	public:
+		/** @param aUiManager Renders and receives input for the UI; 
+		 * not owned. */
+		RemoteUiServer(UiManager *aUiManager, QObject *aParent = NULL);
+		virtual ~RemoteUiServer();
+
+		/** Connects to the local server aServerName of the game.
+		 * @return False if the connection failed. */
+		bool connectToHost(const QString &aServerName);
+
+	private slots:
+		void readMessages();
+
+		/** Renders a frame into a free slot if the UI changed. */
+		void renderFrame();
+
+	private:
+		UiManager *mUiManager;
+		QLocalSocket *mSocket;
+		QSharedMemory *mSharedMemory;
+
+		/** Frame size of the current generation. */
+		QSize mSize;
+		quint32 mGeneration;
+
+		/** True for slots owned by the game. */
+		bool mSlotBusy[Constants::REMOTE_UI_FRAME_SLOTS];
+
+		/** Finds the rectangles which changed since the previous 
+		 * frame. */
+		TileDiff mTileDiff;
+
+		QTimer *mRenderTimer;
+		Qt::CursorShape mCursorShape;
+
+		void resize(const QSize &aSize, const QString &aKey, quint32 aGeneration);
+		void send(const QByteArray &aMessage);
+	};
+}
@@ -0,0 +1,106 @@
+/** This file is part of Cutexture.
+ 
+ Copyright (c) 2010 Markus Weiland, Kevin Lang
+
+ Portions of this code may be under copyright of authors listed in AUTHORS.
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "InputEventSource.h"
+#include "InputRecording.h"
+
+namespace Cutexture
+{
+	/** Input event source which replays a recording written by
+	 * InputRecorder in place of live devices.
+	 *
+	 * In real-time mode, each capture() delivers all recorded frames
+	 * whose timestamp has passed since the replay was started. In
+	 * frame-locked mode, each capture() delivers exactly one
+	 * recorded frame, which replays the recording as fast as the
+	 * application can process it and makes runs deterministic.
+	 */
+	class ReplayInputSource: public InputEventSource
+	{
+	public:
+		/** Opens aFileName for reading. Throws if the file cannot
+		 * be opened or is not an input recording.
+		 * @param aRealTime True for real-time replay, false for
+		 * frame-locked replay. */
+		ReplayInputSource(const QString &aFileName, bool aRealTime);
+		virtual ~ReplayInputSource();
+
+		void setEventCallbacks(OIS::MouseListener *aMouseListener, OIS::KeyListener *aKeyListener);
+		void capture();
+		const OIS::MouseState &getMouseState() const;
+		void setMouseArea(int aWidth, int aHeight);
+
+		/** @return True once all recorded frames were delivered. */
+		bool isFinished() const;
+
+		/** @return True if the recording is replayed in real time. */
+		inline bool isRealTime() const { return mRealTime; }
+
+		/** @return The recorded duration in milliseconds of the
+		 * frame delivered by the last capture(). */
+		inline quint32 getLastFrameDuration() const { return mLastFrameDuration; }
+
+		/** @return The number of recorded frames delivered so far. */
+		inline quint32 getFrameCount() const { return mFrameCount; }
+
+	private:
+		QFile mFile;
+		QDataStream mStream;
+		bool mRealTime;
+
+		OIS::MouseListener *mMouseListener;
+		OIS::KeyListener *mKeyListener;
+
+		/** Mouse state as recorded at the end of the last delivered
+		 * frame. */
+		OIS::MouseState mMouseState;
+
+		/** Time since the replay was started; used in real-time
+		 * mode. */
+		QTime mReplayTime;
+
+		/** Recorded timestamp of the last delivered frame. */
+		quint32 mLastFrameTimestamp;
+		quint32 mLastFrameDuration;
+		quint32 mFrameCount;
+
+		/** Timestamp of the next frame to be delivered; valid if
+		 * mNextFrameTimestampValid is set. */
+		quint32 mNextFrameTimestamp;
+		bool mNextFrameTimestampValid;
+
+		/** Reads and dispatches the records of the next frame up to
+		 * and including its frame record.
+		 * @param aRelative Receives the relative mouse movement of
+		 * the frame. */
+		void replayFrame(OIS::MouseState &aRelative);
+
+		/** Scans ahead to determine the timestamp of the next frame
+		 * without consuming any records. */
+		bool peekNextFrameTimestamp(quint32 &aTimestamp);
+	};
+}
@@ -0,0 +1,115 @@
+/** This file is part of Cutexture.
+ 
+ Copyright (c) 2010 Markus Weiland, Kevin Lang
+
+ Portions of this code may be under copyright of authors listed in AUTHORS.
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "Prerequisites.h"
+
+namespace Cutexture
+{
+	/** Initialises and loads Ogre resource groups without blocking 
+	 * the main loop, so that a loading screen keeps animating and 
+	 * accepting input. Call tick() once per main loop iteration; 
+	 * each call works for at most the given time budget. If Ogre is 
+	 * built with thread support, the resources are prepared, i.e. 
+	 * read and decoded, on Ogre's background queue and only the 
+	 * final load happens in tick(). Progress can be queried from 
+	 * any thread and is reported through signals.
+	 */
+	class ResourceLoader: public QObject, public Ogre::ResourceBackgroundQueue::Listener
+	{
+	Q_OBJECT
+
+	public:
+		ResourceLoader(QObject *aParent = 0);
+		virtual ~ResourceLoader();
+
+		/** Adds the resource group aGroup. Must be called before 
+		 * start(). */
+		void addGroup(const Ogre::String &aGroup);
+
+		/** Adds all resource groups which are not yet loaded. */
+		void addAllGroups();
+
+		/** Starts loading the added groups. */
+		void start();
+
+		/** Continues loading for at most aBudget milliseconds. 
+		 * Must be called on the main thread.
+		 * @return True while loading is not finished. */
+		bool tick(int aBudget);
+
+		/** @return True if start() was called and loading is not 
+		 * finished. Thread-safe. */
+		bool isLoading() const;
+
+		/** @return Number of loaded resources. Thread-safe. */
+		inline int getLoadedCount() const { return mLoadedCount; }
+
+		/** @return Number of resources to load, known once all 
+		 * groups are initialised. Thread-safe. */
+		inline int getTotalCount() const { return mTotalCount; }
+
+		/** @see Ogre::ResourceBackgroundQueue::Listener */
+		void operationCompleted(Ogre::BackgroundProcessTicket aTicket,
+				const Ogre::BackgroundProcessResult &aResult);
+
+	signals:
+		/** Emitted after each loaded resource. aTotal is 0 while 
+		 * the groups are being initialised. */
+		void progressChanged(int aLoaded, int aTotal, const QString &aStatus);
+
+		/** Emitted once all groups are loaded. */
+		void finished();
+
+	private:
+		enum State
+		{
+			StateIdle, StateInitialising, StatePreparing, StateLoading, StateFinished
+		};
+
+		QAtomicInt mState;
+		QAtomicInt mLoadedCount;
+		QAtomicInt mTotalCount;
+
+		Ogre::StringVector mGroups;
+
+		/** Index in mGroups of the next group to initialise. */
+		int mNextGroup;
+
+		/** Resources of mGroups in load order. */
+		QList<Ogre::ResourcePtr> mResources;
+
+		/** Background preparations which are not completed yet. */
+		int mPendingPreparations;
+
+		/** Collects the unloaded resources of mGroups. */
+		void collectResources();
+
+		/** Starts preparing mGroups on Ogre's background queue. 
+		 * @return False without thread support. */
+		bool startPreparing();
+	};
+}
@@ -0,0 +1,149 @@
+/** This file is part of Cutexture.
+ 
+ Copyright (c) 2010 Markus Weiland, Kevin Lang
+
+ Portions of this code may be under copyright of authors listed in AUTHORS.
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "Prerequisites.h"
+
+namespace Cutexture
+{
+	/** Read-only archive of resources, e.g. .ui files, images and 
+	 * Ogre media, in a single file which is mapped into memory. 
+	 * Uncompressed entries start on a page boundary and are read 
+	 * without copying; compressed entries are inflated on each 
+	 * read. Opening one pack instead of hundreds of loose files 
+	 * keeps cold startup fast on slow disks and network file 
+	 * systems.
+	 * 
+	 * Layout, all integers little-endian: a header of 
+	 * Constants::RESOURCE_PACK_HEADER_SIZE bytes (magic, version, 
+	 * entry count, reserved, index offset, index size), the entry 
+	 * data and the index at the end. Each index record holds the 
+	 * UTF-8 name, the offset and stored size of the data, the size 
+	 * after decompression and flags.
+	 * @see ResourcePackWriter, PackArchive
+	 */
+	class ResourcePack
+	{
+	public:
+		ResourcePack();
+		virtual ~ResourcePack();
+
+		/** Maps aFileName into memory and reads its index.
+		 * @return False if the file cannot be mapped or is not a 
+		 * valid pack. */
+		bool open(const QString &aFileName);
+
+		void close();
+
+		inline bool isOpen() const { return (mData != NULL); }
+
+		inline QString getFileName() const { return mFile.fileName(); }
+
+		bool contains(const QString &aName) const;
+
+		/** @return Names of all entries, e.g. "ui/game.ui". */
+		QStringList getEntryNames() const;
+
+		/** @return The size in bytes of entry aName after 
+		 * decompression or -1 if there is no such entry. */
+		qint64 getSize(const QString &aName) const;
+
+		/** @return The size in bytes of entry aName in the file or 
+		 * -1 if there is no such entry. */
+		qint64 getStoredSize(const QString &aName) const;
+
+		bool isCompressed(const QString &aName) const;
+
+		/** @return Pointer to the data of the uncompressed entry 
+		 * aName in the mapped file, valid until close(). Null if 
+		 * there is no such entry or it is compressed. */
+		const uchar* map(const QString &aName) const;
+
+		/** @return The contents of entry aName or an empty array. 
+		 * For uncompressed entries, the array refers to the mapped 
+		 * file without a copy and must not be used after close(). */
+		QByteArray read(const QString &aName) const;
+
+	private:
+		Q_DISABLE_COPY(ResourcePack)
+
+		struct Entry
+		{
+			qint64 offset;
+			qint64 storedSize;
+			qint64 size;
+			quint32 flags;
+		};
+
+		QFile mFile;
+		uchar *mData;
+		qint64 mDataSize;
+		QHash<QString, Entry> mEntries;
+
+		bool readIndex();
+
+		friend class ResourcePackWriter;
+
+		/** Flag of entries stored with qCompress(). */
+		static const quint32 ENTRY_COMPRESSED = 0x1;
+	};
+
+	/** Creates ResourcePack files, e.g. in the resource-packer 
+	 * tool.
+	 */
+	class ResourcePackWriter
+	{
+	public:
+		ResourcePackWriter();
+		virtual ~ResourcePackWriter();
+
+		/** Adds the entry aName. With aCompress, it is stored 
+		 * compressed if that saves at least a quarter of its size. 
+		 * Replaces an existing entry with the same name. */
+		void addEntry(const QString &aName, const QByteArray &aData, bool aCompress = false);
+
+		/** Adds the contents of aFileName as entry aName.
+		 * @return False if the file cannot be read. */
+		bool addFile(const QString &aName, const QString &aFileName, bool aCompress = false);
+
+		inline int getEntryCount() const { return mEntries.size(); }
+
+		/** Writes all entries into the pack file aFileName.
+		 * @return False on I/O errors. */
+		bool write(const QString &aFileName) const;
+
+	private:
+		struct PendingEntry
+		{
+			QByteArray data;
+			qint64 size;
+			bool compressed;
+		};
+
+		/** Sorted by name, so that packs are reproducible. */
+		QMap<QString, PendingEntry> mEntries;
+	};
+}
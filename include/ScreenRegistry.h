@@ -0,0 +1,131 @@
+/** This file is part of Cutexture.
+ 
+ Copyright (c) 2010 Markus Weiland, Kevin Lang
+
+ Portions of this code may be under copyright of authors listed in AUTHORS.
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "Prerequisites.h"
+
+namespace Cutexture
+{
+	/** Named UI screens built from .ui files. Each file is read 
+	 * once on registration, and built widget trees are kept in a 
+	 * pool while other screens are shown, so switching screens 
+	 * only swaps visibility. When the estimated memory of the 
+	 * hidden screens exceeds the pool limit, the least recently 
+	 * used ones are destroyed and rebuilt from the cached file 
+	 * when needed again.
+	 */
+	class ScreenRegistry
+	{
+	public:
+		ScreenRegistry(UiManager *aUiManager);
+		virtual ~ScreenRegistry();
+
+		/** Registers the screen aName, built from the .ui file 
+		 * aUiFile. The file is read immediately. */
+		void registerScreen(const QString &aName, const QString &aUiFile);
+
+		/** Registers the screen aName, built from the contents of 
+		 * a .ui file, e.g. from ResourcePack::read(). aForm is kept 
+		 * as an implicitly shared copy, so its data is not 
+		 * duplicated unless it is modified afterwards. */
+		void registerScreen(const QString &aName, const QByteArray &aForm);
+
+		/** Makes the screen aName the active widget of the 
+		 * UiManager.
+		 * @return The widget of the screen. */
+		QWidget* showScreen(const QString &aName);
+
+		/** Builds the screen aName without showing it, e.g. to 
+		 * prepare it while a level loads. Changes made to the 
+		 * returned widget are lost if it is evicted from the pool; 
+		 * building it may evict other hidden screens.
+		 * @return The widget of the screen. */
+		QWidget* getScreen(const QString &aName);
+
+		/** Builds the screen aName and paints it off-screen, so 
+		 * that showing it for the first time does not stall on 
+		 * rasterizing glyphs and decoding images. 
+		 * @see UiManager::prewarmWidget() */
+		void prewarmScreen(const QString &aName);
+
+		/** Prewarms all registered screens. */
+		void prewarmAll();
+
+		inline const QString& getActiveScreen() const { return mActiveScreen; }
+
+		/** Limits the estimated memory in bytes of the hidden 
+		 * screens kept in the pool. 0 destroys screens as soon as 
+		 * they are hidden. */
+		void setMaxPoolCost(qint64 aBytes);
+
+		inline qint64 getMaxPoolCost() const { return mMaxPoolCost; }
+
+		/** @return The estimated memory in bytes of the hidden 
+		 * screens in the pool. */
+		qint64 getPoolCost() const;
+
+	private:
+		struct Screen
+		{
+			/** Contents of the .ui file. */
+			QByteArray form;
+
+			/** Null if not built or evicted. */
+			QWidget *widget;
+
+			/** Estimated memory in bytes; updated whenever the 
+			 * screen has been laid out. @see estimateCost() */
+			qint64 cost;
+
+			/** Value of mUseCounter when last shown. */
+			quint64 lastUsed;
+		};
+
+		UiManager *mUiManager;
+		QHash<QString, Screen> mScreens;
+		QString mActiveScreen;
+		qint64 mMaxPoolCost;
+		quint64 mUseCounter;
+
+		Screen& findScreen(const QString &aName);
+
+		/** Builds aScreen from its form if needed. */
+		void build(Screen &aScreen);
+
+		/** Evicts the least recently used hidden screens until 
+		 * the pool is within its limit. 
+		 * @param aKeep Screen which is never evicted, e.g. the one 
+		 * just returned by getScreen(). */
+		void trimPool(const Screen *aKeep = NULL);
+
+		/** @return Rough memory estimate of aWidget: the pixels of 
+		 * its top-level area, which is cached once when shown 
+		 * through a proxy, plus a fixed cost per widget. Only 
+		 * meaningful once aWidget has been laid out at the size it 
+		 * is shown at. */
+		static qint64 estimateCost(QWidget *aWidget);
+	};
+}
@@ -0,0 +1,119 @@
+/** This file is part of Cutexture.
+ 
+ Copyright (c) 2010 Markus Weiland, Kevin Lang
+
+ Portions of this code may be under copyright of authors listed in AUTHORS.
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "Prerequisites.h"
+
+namespace Cutexture
+{
+	/** Runs the steps of application startup as a dependency 
+	 * graph. A step starts as soon as all steps it depends on have 
+	 * finished; steps which may leave the main thread run 
+	 * concurrently on Qt's global thread pool while the main thread 
+	 * works on the others. The duration of each step and of the 
+	 * whole startup is logged.
+	 * 
+	 * Steps are slots or Q_INVOKABLE methods without arguments. 
+	 * Anything that touches widgets, the render system or other 
+	 * objects without thread support must run on the main thread.
+	 */
+	class StartupPipeline
+	{
+	public:
+		StartupPipeline();
+		virtual ~StartupPipeline();
+
+		/** Adds the step aName which calls aMethod of aReceiver, 
+		 * e.g. addStep("settings", this, "loadSettings").
+		 * @param aDependencies Names of the steps which must finish 
+		 * before this one starts. 
+		 * @param aWorkerThread If true, the step runs on a worker 
+		 * thread. */
+		void addStep(const QString &aName, QObject *aReceiver, const char *aMethod,
+				const QStringList &aDependencies = QStringList(), bool aWorkerThread = false);
+
+		/** Runs all steps and returns once they are finished. 
+		 * Throws if a step throws, after the running steps have 
+		 * finished, or if the dependencies cannot be satisfied. */
+		void run();
+
+		/** @return Duration in milliseconds of step aName in the 
+		 * last run() or -1. */
+		int getStepDuration(const QString &aName) const;
+
+		/** @return Duration in milliseconds of the last run(). */
+		inline int getTotalDuration() const { return mTotalDuration; }
+
+	private:
+		Q_DISABLE_COPY(StartupPipeline)
+
+		enum StepState
+		{
+			StepPending, StepRunning, StepFinished
+		};
+
+		struct Step
+		{
+			QString name;
+			QObject *receiver;
+			QByteArray method;
+			QStringList dependencies;
+			bool workerThread;
+
+			StepState state;
+
+			/** Milliseconds since the start of run(). */
+			int startTime;
+			int duration;
+
+			/** Set if the step threw. */
+			QString error;
+		};
+
+		QList<Step> mSteps;
+
+		/** Measures the time since the start of run(). */
+		QTime mClock;
+		int mTotalDuration;
+
+		/** Guards the state, timing and error of mSteps while 
+		 * workers run. */
+		QMutex mMutex;
+
+		/** Released once by each finished worker step. */
+		QSemaphore mWorkerFinished;
+
+		/** Calls the method of step aIndex and records its timing 
+		 * and errors. */
+		void runStep(int aIndex);
+
+		/** @return True if all dependencies of aStep have 
+		 * finished. */
+		bool isReady(const Step &aStep) const;
+
+		void logTimings() const;
+	};
+}
@@ -0,0 +1,106 @@
+/** This file is part of Cutexture.
+ 
+ Copyright (c) 2010 Markus Weiland, Kevin Lang
+
+ Portions of this code may be under copyright of authors listed in AUTHORS.
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "InputEventSource.h"
+
+namespace Cutexture
+{
+	/** Input event source which does not need OIS devices or a
+	 * render window. Events are injected programmatically and are
+	 * delivered as regular OIS::MouseEvent and OIS::KeyEvent
+	 * instances on the next capture(). Useful for automated tests,
+	 * benchmarks and applications without a window.
+	 */
+	class SyntheticInputSource: public InputEventSource
+	{
+	public:
+		/** @param aMouseArea Area to which absolute mouse coordinates
+		 * are clipped. */
+		SyntheticInputSource(const QSize &aMouseArea);
+		virtual ~SyntheticInputSource();
+
+		void setEventCallbacks(OIS::MouseListener *aMouseListener, OIS::KeyListener *aKeyListener);
+		void capture();
+		const OIS::MouseState &getMouseState() const;
+		void setMouseArea(int aWidth, int aHeight);
+
+		/** Queues a mouse movement to the absolute position
+		 * (aX, aY). */
+		void injectMouseMove(int aX, int aY);
+		/** Queues a mouse wheel rotation by aDelta. */
+		void injectMouseWheel(int aDelta);
+		/** Queues a mouse button press at the current position. */
+		void injectMousePress(OIS::MouseButtonID aButton);
+		/** Queues a mouse button release at the current position. */
+		void injectMouseRelease(OIS::MouseButtonID aButton);
+		/** Queues a key press.
+		 * @param aKey OIS key code.
+		 * @param aText Unicode character produced by the key or 0. */
+		void injectKeyPress(OIS::KeyCode aKey, unsigned int aText = 0);
+		/** Queues a key release. @see injectKeyPress() */
+		void injectKeyRelease(OIS::KeyCode aKey, unsigned int aText = 0);
+
+		/** @return The number of events queued for the next
+		 * capture(). */
+		inline int getPendingEventCount() const { return mPendingEvents.size(); }
+
+	private:
+		enum EventType
+		{
+			MouseMove,
+			MouseWheel,
+			MousePress,
+			MouseRelease,
+			KeyPress,
+			KeyRelease
+		};
+
+		/** A queued event. Unused fields are zero. */
+		struct SyntheticEvent
+		{
+			EventType type;
+			int x;
+			int y;
+			int z;
+			OIS::MouseButtonID button;
+			OIS::KeyCode key;
+			unsigned int text;
+		};
+
+		OIS::MouseListener *mMouseListener;
+		OIS::KeyListener *mKeyListener;
+
+		/** Mouse state as it would be reported by an OIS mouse. */
+		OIS::MouseState mMouseState;
+
+		/** Events waiting to be delivered by capture(). */
+		QVector<SyntheticEvent> mPendingEvents;
+
+		void queueEvent(EventType aType, int aX, int aY, int aZ, OIS::MouseButtonID aButton,
+				OIS::KeyCode aKey, unsigned int aText);
+	};
+}
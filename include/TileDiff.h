@@ -0,0 +1,74 @@
+/** This file is part of Cutexture.
+ 
+ Copyright (c) 2010 Markus Weiland, Kevin Lang
+
+ Portions of this code may be under copyright of authors listed in AUTHORS.
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "Prerequisites.h"
+
+namespace Cutexture
+{
+	/** Finds the parts of an image that changed since the previous
+	 * frame. The image is split into square tiles and a 64-bit hash
+	 * is kept per tile, so no copy of the previous frame is needed.
+	 * Used to upload only the tiles which really changed when Qt
+	 * reports more damage than there is.
+	 */
+	class TileDiff
+	{
+	public:
+		/** @param aTileSize Edge length of a tile in pixels. */
+		TileDiff(int aTileSize);
+		virtual ~TileDiff();
+
+		/** Hashes all tiles of aImage and compares them with the
+		 * hashes of the image passed to the previous call. If the
+		 * image size changed or reset() was called, all tiles are
+		 * reported as changed.
+		 * @param aImage A 32-bit image.
+		 * @return Rectangles covering all changed tiles. Adjacent
+		 * changed tiles in a tile row are merged into one
+		 * rectangle. */
+		QVector<QRect> update(const QImage &aImage);
+
+		/** Forgets all tile hashes, e.g. after the texture contents
+		 * were lost. */
+		void reset();
+
+		inline int getTileSize() const { return mTileSize; }
+
+		/** @return A 64-bit hash of the pixels of aImage inside
+		 * aRect. aImage must be a 32-bit image. */
+		static quint64 hashRect(const QImage &aImage, const QRect &aRect);
+
+	private:
+		int mTileSize;
+
+		/** Size of the image passed to the last update(). */
+		QSize mImageSize;
+
+		/** Hash per tile, row by row. */
+		QVector<quint64> mTileHashes;
+	};
+}
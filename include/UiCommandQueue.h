@@ -0,0 +1,131 @@
+/** This file is part of Cutexture.
+ 
+ Copyright (c) 2010 Markus Weiland, Kevin Lang
+
+ Portions of this code may be under copyright of authors listed in AUTHORS.
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "Prerequisites.h"
+
+namespace Cutexture
+{
+	/** Property changes collected by one producer, e.g. a game 
+	 * system running on a worker thread, and posted to a 
+	 * UiCommandQueue at once. Setting the same property of the same 
+	 * object twice keeps only the last value. A batch itself is 
+	 * not thread-safe; use one per thread.
+	 */
+	class UiCommandBatch
+	{
+	public:
+		UiCommandBatch();
+		virtual ~UiCommandBatch();
+
+		/** Sets the Qt property aProperty of aTarget to aValue when 
+		 * the batch is applied. aTarget must not be deleted before 
+		 * that. */
+		void setProperty(QObject *aTarget, const char *aProperty, const QVariant &aValue);
+
+		/** Sets the text of e.g. a QLabel, QLineEdit or 
+		 * QAbstractButton. */
+		inline void setText(QObject *aTarget, const QString &aText)
+			{ setProperty(aTarget, "text", aText); }
+
+		/** Sets the value of e.g. a QAbstractSlider, QProgressBar 
+		 * or QSpinBox. */
+		inline void setValue(QObject *aTarget, int aValue)
+			{ setProperty(aTarget, "value", aValue); }
+
+		/** Shows or hides a QWidget. */
+		inline void setVisible(QObject *aTarget, bool aVisible)
+			{ setProperty(aTarget, "visible", aVisible); }
+
+		inline bool isEmpty() const { return mCommands.isEmpty(); }
+		inline int size() const { return mCommands.size(); }
+
+		void clear();
+
+	private:
+		friend class UiCommandQueue;
+
+		struct Command
+		{
+			QObject *target;
+			QByteArray property;
+			QVariant value;
+		};
+
+		typedef QPair<QObject *, QByteArray> PropertyKey;
+
+		QVector<Command> mCommands;
+
+		/** Index in mCommands by target and property. */
+		QHash<PropertyKey, int> mCommandIndices;
+	};
+
+	/** Lock-free multi-producer queue of UI property changes. Any 
+	 * thread can post batches without taking a lock or sending 
+	 * events; the thread which owns the widgets applies all of them 
+	 * at a defined point in the frame. Each posted batch costs a 
+	 * single compare-and-swap.
+	 * @see UiManager::applyCommands()
+	 */
+	class UiCommandQueue
+	{
+	public:
+		UiCommandQueue();
+		virtual ~UiCommandQueue();
+
+		/** Moves the commands of aBatch into the queue; aBatch is 
+		 * empty afterwards. Thread-safe. */
+		void post(UiCommandBatch &aBatch);
+
+		/** Posts a single property change. Thread-safe. 
+		 * @see UiCommandBatch::setProperty() */
+		void post(QObject *aTarget, const char *aProperty, const QVariant &aValue);
+
+		/** Applies all posted commands in the order they were 
+		 * posted. Of several changes of the same property of the 
+		 * same object, only the last one is applied. Call from the 
+		 * thread which owns the targets.
+		 * @return The number of applied property changes. */
+		int apply();
+
+		/** @return True if nothing was posted since the last 
+		 * apply(). */
+		bool isEmpty() const;
+
+	private:
+		Q_DISABLE_COPY(UiCommandQueue)
+
+		struct Node
+		{
+			Node *next;
+			QVector<UiCommandBatch::Command> commands;
+		};
+
+		/** Most recently posted batch; older batches follow 
+		 * through Node::next. */
+		QAtomicPointer<Node> mHead;
+	};
+}
@@ -26,6 +26,11 @@
 #pragma once
 
 #include "InputManager.h"
+#include "Constants.h"
+#include "Enums.h"
+#include "BlockCompression.h"
+#include "UiCommandQueue.h"
+#include "DataBinder.h"
 
 #include <QtCore/QObject>
 
@@ -35,16 +40,70 @@ namespace Cutexture
 	 * user interface states and reacting to user and system 
 	 * events which relate to the user interface.
 	 */
-	class UiManager: public QObject
+	class UiManager: public QObject, public Ogre::RenderQueueListener, public Ogre::FrameListener
 	{
 	Q_OBJECT
 	public:
-		UiManager();
+		/** @param aBackend How the UI is embedded and rendered. */
+		UiManager(Enums::UiBackend aBackend = Enums::UiBackendGraphicsView);
 		virtual ~UiManager();
+		
+		inline Enums::UiBackend getBackend() const { return mBackend; }
+		
+		/** @return The scene of the graphics view backend, e.g. to 
+		 * add items next to the UI widget; NULL for the other 
+		 * backends. */
+		inline QGraphicsScene* getScene() { return mWidgetScene; }
 
-		/** Sets aWidget as the currently visible UI widget. */
+		/** Sets aWidget as the currently visible UI widget. Cache 
+		 * modes given by the Constants::UI_CACHE_MODE_PROPERTY 
+		 * property of aWidget and its descendants are applied. The 
+		 * previously active widget is destroyed unless it is 
+		 * retained. */
 		void setActiveWidget(QWidget *aWidget);
 		
+		/** Keeps aWidget alive while another widget is active. It 
+		 * is only hidden when replaced, and making it active again 
+		 * neither rebuilds nor re-embeds it. We take ownership.
+		 * @see ScreenRegistry */
+		void retainWidget(QWidget *aWidget);
+		
+		/** Stops retaining aWidget and destroys it. The active 
+		 * widget is destroyed once it is replaced. */
+		void releaseWidget(QWidget *aWidget);
+		
+		inline bool isRetained(QWidget *aWidget) const { return mRetainedWidgets.contains(aWidget); }
+		
+		/** With Enums::UiBackendRemoteProcess, starts the helper 
+		 * process which runs the UI, instead of setting an active 
+		 * widget. The helper receives the name of a local server 
+		 * as first argument, followed by aArguments, and is 
+		 * expected to run a RemoteUiServer.
+		 * @return False if the helper did not connect. */
+		bool startRemoteUi(const QString &aProgram, const QStringList &aArguments);
+		
+		/** @return True, if the UI helper process is connected. */
+		bool isRemoteUiConnected() const;
+		
+		/** Sets how aWidget and its subtree are cached. Only 
+		 * supported by Enums::UiBackendGraphicsView. A 
+		 * descendant of the active widget gets its own proxy item 
+		 * in the scene so that it is cached and composed 
+		 * separately from the rest of the UI.
+		 * 
+		 * Pixmap caches are invalidated automatically when the 
+		 * subtree updates. Recorded pictures are only invalidated 
+		 * on resize, style, font, palette and child changes of 
+		 * aWidget or by invalidateWidgetCache(); use them for 
+		 * panels which do not change on their own.
+		 * @param aWidget The active widget or one of its 
+		 * descendants. */
+		void setWidgetCacheMode(QWidget *aWidget, Enums::WidgetCacheMode aMode);
+		
+		/** Discards the cached contents of aWidget, which must have 
+		 * been passed to setWidgetCacheMode() before. */
+		void invalidateWidgetCache(QWidget *aWidget);
+		
 		/** Sets the InputManager which will provide input events 
 		 * to the UI. */
 		void setInputManager(InputManager *aInputManager);
@@ -52,27 +111,263 @@ namespace Cutexture
 		/** @return True, if the UI texture needs to be repainted. */
 		inline bool isUiDirty() const { return mUiDirty; }
 		
+		/** Returns the bounding rectangle of all UI content which 
+		 * may be non-transparent, in window coordinates. The overlay 
+		 * which displays the UI texture only needs to cover this 
+		 * rectangle. For a top-level widget with a translucent 
+		 * background (Qt::WA_TranslucentBackground), only its child 
+		 * widgets are considered content.
+		 * @return The content bounds or an empty rectangle if the UI 
+		 * is completely transparent. */
+		QRect getContentBounds() const;
+		
+		/** @return The cursor of the widget under the mouse, as of 
+		 * the last mouse event. For drawing the cursor separately 
+		 * from the UI, e.g. with a CursorLayer. */
+		QCursor getCursor() const;
+		
+		/** Puts the UI into hibernation, e.g. while the render 
+		 * window is minimized. The application should not call 
+		 * renderIntoTexture() while the UI is hibernating.
+		 * @param aTexture The UI texture.
+		 * @param aReleaseResources If true, the hardware resources 
+		 * of aTexture are freed and Qt's pixmap cache is cleared.
+		 * @see resume() */
+		void hibernate(const Ogre::TexturePtr &aTexture, bool aReleaseResources);
+		
+		/** Ends hibernation. Recreates the resources released by 
+		 * hibernate() and marks the UI dirty so that it is 
+		 * repainted completely.
+		 * @param aTexture The UI texture passed to hibernate(). */
+		void resume(const Ogre::TexturePtr &aTexture);
+		
+		/** @return True, if the UI is hibernating. */
+		inline bool isHibernating() const { return mHibernating; }
+		
 		/** Renders mTopLevelWidget into the texture specified by 
 		 * aTexture. */
 		void renderIntoTexture(const Ogre::TexturePtr &aTexture);
+		
+		/** Renders mTopLevelWidget into aImage, e.g. for 
+		 * benchmarking without a render system. Tile diffing, 
+		 * format conversion and static UI encoding are not 
+		 * applied.
+		 * @param aImage An image of format QImage::Format_ARGB32. */
+		void renderIntoImage(QImage &aImage);
+		
+		/** Paints aWidget once into a throwaway image, at the size 
+		 * and scale of the UI, so that its glyphs, icons and style 
+		 * pixmaps are in Qt's caches before it is shown for the 
+		 * first time. Hidden and not yet active widgets are 
+		 * supported; popups are not painted.
+		 * @see ScreenRegistry::prewarmScreen() */
+		void prewarmWidget(QWidget *aWidget);
+		
+		/** Rasterizes the glyphs of aCharacters in aFont at the 
+		 * scale of the UI into Qt's glyph cache, e.g. the digits of 
+		 * a HUD counter which first appear while playing. */
+		void prewarmText(const QFont &aFont, const QString &aCharacters);
+		
+		/** Writes to Ogre's log what the prewarm calls so far have 
+		 * put into Qt's caches and how long they took. */
+		void logPrewarmStatistics() const;
+		
+		/** Enables or disables tile diffing. If enabled, 
+		 * renderIntoTexture() rasterizes the UI into a system memory 
+		 * image, compares it tile by tile with the previous frame 
+		 * and uploads only the tiles that really changed. This pays 
+		 * off when widgets report more damage than they repaint, 
+		 * at the cost of hashing the whole image every frame.
+		 * @param aTileSize Edge length of a tile in pixels. */
+		void setTileDiffing(bool aEnabled, int aTileSize = Constants::UI_TILE_SIZE);
+		
+		/** @return True, if tile diffing is enabled. */
+		inline bool isTileDiffing() const { return mTileDiff != NULL; }
+		
+		/** @return The number of pixels uploaded by the last call 
+		 * of renderIntoTexture(). */
+		inline int getLastUploadedPixels() const { return mLastUploadedPixels; }
+		
+		/** Enables or disables parallel rasterization. If enabled 
+		 * and any visible item in the scene is marked with 
+		 * setThreadSafePainting(), renderIntoTexture() splits the 
+		 * texture into horizontal bands. The marked items are 
+		 * painted into them concurrently on 
+		 * QThreadPool::globalInstance(), all other items, e.g. the 
+		 * embedded QWidgets, on the calling thread, keeping the 
+		 * stacking order. Otherwise the UI is rendered on the 
+		 * calling thread as usual. */
+		void setParallelRendering(bool aEnabled);
+		
+		/** @return True, if parallel rasterization is enabled. */
+		inline bool isParallelRendering() const { return mParallelRendering; }
+		
+		/** @return The number of bands rasterized concurrently by 
+		 * the last call of renderIntoTexture(); 1 if the UI was 
+		 * rendered on the calling thread. */
+		inline int getLastRenderBandCount() const { return mLastRenderBandCount; }
+		
+		/** Enables late latching of the UI texture. Instead of the 
+		 * application calling renderIntoTexture() before rendering 
+		 * a frame, a dirty UI is rendered into aTexture from within 
+		 * Ogre's frame, right before the overlay render queue group 
+		 * of aSceneManager is drawn. The scene has been submitted 
+		 * by then, so the GPU renders it while the UI is rasterized, 
+		 * and the UI reflects all input processed up to that point. 
+		 * If the overlay group was not rendered, e.g. because it is 
+		 * empty, a dirty UI is rendered when the frame ends. 
+		 * Pass a null scene manager to disable late latching. */
+		void setLateLatching(Ogre::SceneManager *aSceneManager, const Ogre::TexturePtr &aTexture);
+		
+		/** @return True, if late latching is enabled. */
+		inline bool isLateLatching() const { return mLateLatchSceneManager != NULL; }
+		
+		/** @see Ogre::RenderQueueListener */
+		void renderQueueStarted(Ogre::uint8 aQueueGroupId, const Ogre::String &aInvocation,
+				bool &aSkipThisInvocation);
+		void renderQueueEnded(Ogre::uint8 aQueueGroupId, const Ogre::String &aInvocation,
+				bool &aRepeatThisInvocation);
+		
+		/** @see Ogre::FrameListener */
+		bool frameEnded(const Ogre::FrameEvent &aEvent);
+		
+		/** Enables or disables driving Qt's animations from 
+		 * advanceFrame(). If enabled, all animations of the 
+		 * application advance exactly once per call instead of on 
+		 * Qt's own timer which ticks independently of the render 
+		 * loop. The animation time still comes from Qt's clock. 
+		 * Only one UiManager can drive the animations. Requires 
+		 * Qt 4.8; ignored with older versions. */
+		void setFrameClock(bool aEnabled);
+		
+		/** @return True, if Qt's animations are driven by 
+		 * advanceFrame(). */
+		bool isFrameClock() const;
+		
+		/** Starts a new frame. Call once per frame before the UI is 
+		 * rendered. Advances Qt's animations if the frame clock is 
+		 * enabled and a repaint is due.
+		 * @param aFrameTime Timestamp of the frame in milliseconds, 
+		 * e.g. from Ogre's timer; used to limit the repaint rate. */
+		void advanceFrame(qint64 aFrameTime);
+		
+		/** Limits how often the UI is repainted. Intermediate 
+		 * changes, e.g. animation steps, are coalesced into the 
+		 * next repaint. Relies on the timestamps passed to 
+		 * advanceFrame().
+		 * @param aRate Maximum repaints per second or 0 for no 
+		 * limit. */
+		void setMaxRepaintRate(int aRate);
+		
+		inline int getMaxRepaintRate() const { return mMaxRepaintRate; }
+		
+		/** @return True, if the UI is dirty and the maximum repaint 
+		 * rate allows repainting it in the current frame. */
+		bool isRepaintDue() const;
+		
+		/** @return True, if Qt's animations are running while the 
+		 * frame clock is enabled. */
+		bool isAnimating() const;
+		
+		/** @return Queue through which game threads post changes 
+		 * to the UI's widgets. */
+		inline UiCommandQueue* getCommandQueue() { return &mCommandQueue; }
+		
+		/** Applies the changes posted to getCommandQueue() since 
+		 * the last call. Call once per frame from the GUI thread, 
+		 * before advanceFrame(), so the changes are painted in the 
+		 * same frame.
+		 * @return The number of applied property changes. */
+		int applyCommands();
+		
+		/** @return Bindings of game values to the properties of 
+		 * named widgets in the active widget. Wrap the updates of a 
+		 * frame in DataBinder::begin() and DataBinder::commit(). */
+		inline DataBinder* getDataBinder() { return &mDataBinder; }
+		
+		/** Marks aItem as safe to paint from worker threads. Its 
+		 * paint() must be reentrant, may be called concurrently for 
+		 * different bands and must not use QPixmap or touch other 
+		 * objects which belong to the GUI thread. Scenes with 
+		 * graphics effects or clipping items are always rendered 
+		 * on the calling thread. */
+		static void setThreadSafePainting(QGraphicsItem *aItem, bool aThreadSafe = true);
 
+		/** Sets the pixel format of the UI texture. Formats other 
+		 * than Enums::TextureFormatARGB8888 are rasterized into 
+		 * system memory first and converted while uploading. 
+		 * Takes effect with the next resizeTexture(). */
+		void setTextureFormat(Enums::TextureFormat aFormat);
+		
+		inline Enums::TextureFormat getTextureFormat() const { return mTextureFormat; }
+		
+		/** Sets the colour of the UI if the texture format is 
+		 * Enums::TextureFormatAlpha8. Takes effect with the next 
+		 * resizeTexture(). */
+		void setTintColour(const QColor &aColour);
+		
+		/** Marks the UI as static, e.g. for menus and loading 
+		 * screens. Once a static UI has not changed for 
+		 * Constants::UI_STATIC_ENCODE_DELAY milliseconds, it is 
+		 * encoded to BC1 (opaque) or BC3 on a worker thread and 
+		 * displayed from a compressed texture; the uncompressed 
+		 * texture's hardware buffers are released meanwhile. The 
+		 * next renderIntoTexture() switches back to the 
+		 * uncompressed texture. Only used with 
+		 * Enums::TextureFormatARGB8888 and if the render system 
+		 * supports DXT textures. */
+		void setStaticUi(bool aStatic);
+		
+		inline bool isStaticUi() const { return mStaticUi; }
+		
+		/** @return True, if the UI is currently displayed from the 
+		 * block-compressed texture. */
+		inline bool isCompressedTextureShown() const { return mCompressedTextureShown; }
+		
+		/** Sets the resolution at which the UI is laid out. The 
+		 * UI is stretched to the window by the overlay, e.g. a 
+		 * UI laid out at 1920x1080 is upscaled on a 4K window. 
+		 * Takes effect with the next resizeTexture() and 
+		 * resizeUi().
+		 * @param aResolution The virtual resolution or an empty 
+		 * size to lay out the UI at window size. */
+		void setVirtualResolution(const QSize &aResolution);
+		
+		/** Sets the scale from layout to texture pixels. E.g. at 
+		 * 0.5, a quarter of the pixels are rasterized and uploaded 
+		 * and the overlay upscales them to the window. Takes 
+		 * effect with the next resizeTexture() and resizeUi(). */
+		void setRenderScale(qreal aScale);
+		
+		inline const QSize& getVirtualResolution() const { return mVirtualResolution; }
+		inline qreal getRenderScale() const { return mRenderScale; }
+		
+		/** @return The size at which the UI is laid out for a 
+		 * window of size aWindowSize. */
+		QSize getLayoutSize(const QSize &aWindowSize) const;
+		
+		/** @return The size in texture pixels of the UI for a 
+		 * window of size aWindowSize. */
+		QSize getRenderSize(const QSize &aWindowSize) const;
+		
 		/** Recreates the texture aTexture with a power-of-two 
-		 * sized texture whose size is greater or equal to aSize.
-		 * @param aSize Minimum size of the texture aTexture.
+		 * sized texture whose size is greater or equal to the 
+		 * render size of the UI.
+		 * @param aSize Size of the render window.
 		 * @param aMaterial Material to assign aTexture to.
 		 * @param aTexture The texture to resize.
 		 */
 		void resizeTexture(const QSize &aSize, const Ogre::MaterialPtr &aMaterial, 
 				const Ogre::TexturePtr &aTexture);
 		
-		/** Resizes the active UI widget to the size in 
-		 * aEvent->size(). Note: This is not the same as setting 
+		/** Resizes the active UI widget to the layout size for a 
+		 * window of size aEvent->size(). Note: This is not the same as setting 
 		 * the view size. Resizing the UI changes the actual 
 		 * size of the widgets whereas changing the view size 
 		 * simply changes the size of the viewport which displays 
 		 * the UI.
-		 * @param aEvent Target widget size. 
-		 * @see setViewSize() */
+		 * @param aEvent New render window size. 
+		 * @see setViewSize(), getLayoutSize() */
 		void resizeUi(QResizeEvent *aEvent);
 		
 		/** @return True, if the size of mWidgetView is equal to the 
@@ -80,10 +375,14 @@ namespace Cutexture
 		bool isViewSizeMatching(const Ogre::TexturePtr &aTexture) const;
 		
 		/** Sets mWidgetView's geometry to aTexture's dimensions 
-		 * if it is not already of this size.
+		 * if it is not already of this size and scales the view 
+		 * from the layout size to the render size.
 		 * @param aTexture The texture to fit mWidgetView to. */
 		void setViewSize(const Ogre::TexturePtr &aTexture);
 		
+		/** @see setViewSize(const Ogre::TexturePtr &) */
+		void setViewSize(const QSize &aSize);
+		
 	public slots:
 		/** @see QWidget::mousePressEvent() */
 		void mousePressEvent(QMouseEvent *event);
@@ -101,13 +400,35 @@ namespace Cutexture
 		 * false by the application. */
 		void setUiDirty(bool aDirty = true);
 
+	protected:
+		/** Marks the UI dirty when the directly rendered widget 
+		 * requests an update. The request is passed on since Qt only 
+		 * schedules further update requests once it was processed. */
+		bool eventFilter(QObject *aObject, QEvent *aEvent);
+		
+	private slots:
+		/** Starts encoding the static UI on a worker thread. */
+		void encodeStaticUi();
+		
+		/** Uploads the encoded static UI and displays it. */
+		void staticUiEncoded();
+		
 	private:
 		
+		/** @see getBackend() */
+		Enums::UiBackend mBackend;
+		
+		/** Connection to the UI helper process. Null unless 
+		 * Enums::UiBackendRemoteProcess. Owned by us. */
+		RemoteUiClient *mRemoteUi;
+		
 		/** Scene which contains all the user interface widgets
-		 * as QGraphicsWidget items. */
+		 * as QGraphicsWidget items. Null with 
+		 * Enums::UiBackendDirectWidget. */
 		QGraphicsScene *mWidgetScene;
 
-		/** View which visualizes the scene containing UI widgets. */
+		/** View which visualizes the scene containing UI widgets. 
+		 * Null with Enums::UiBackendDirectWidget. */
 		QGraphicsView *mWidgetView;
 
 		/** Top-level widget in the graphics scene. */
@@ -117,6 +438,18 @@ namespace Cutexture
 		 * Null if no focus set. */
 		QWidget *mFocusedWidget;
 		
+		/** With Enums::UiBackendDirectWidget, the widget which 
+		 * receives mouse events while a button is held. */
+		QWidget *mMouseGrabber;
+		
+		/** With Enums::UiBackendDirectWidget, the widget under the 
+		 * mouse cursor. */
+		QWidget *mHoveredWidget;
+		
+		/** Position of the last mouse event in window coordinates. 
+		 * @see getCursor() */
+		QPoint mMousePosition;
+		
 		/** Indicates if the UI texture needs to be updated due to a  
 		 * change in mWidgetScene. */
 		bool mUiDirty;
@@ -124,5 +457,169 @@ namespace Cutexture
 		/** Pointer to InputManager which provides input events to 
 		 * the UI. */
 		InputManager *mInputManager;
+		
+		/** Indicates if the UI is hibernating. 
+		 * @see hibernate() */
+		bool mHibernating;
+		
+		/** Tile hashes of the last uploaded frame. Null if tile 
+		 * diffing is disabled. */
+		TileDiff *mTileDiff;
+		
+		/** Indicates if the texture area outside of the render size 
+		 * has to be cleared by the next tile diffing upload. */
+		bool mTexturePaddingDirty;
+		
+		/** System memory copy of the UI texture contents; only used 
+		 * with tile diffing or texture format conversion. With tile 
+		 * diffing, it only covers the render size. */
+		QImage mTextureImage;
+		
+		/** @see getLastUploadedPixels() */
+		int mLastUploadedPixels;
+		
+		/** @see setTextureFormat() */
+		Enums::TextureFormat mTextureFormat;
+		
+		/** @see setTintColour() */
+		QColor mTintColour;
+		
+		/** Holds converted pixels of a tile until they are 
+		 * uploaded. */
+		QByteArray mConversionBuffer;
+		
+		/** @see setStaticUi() */
+		bool mStaticUi;
+		
+		/** Delays encoding until the UI stopped changing. */
+		QTimer *mStaticEncodeTimer;
+		
+		/** Watches the encoding of the static UI. */
+		QFutureWatcher<Utility::CompressedImage> *mEncodeWatcher;
+		
+		/** Incremented whenever the UI texture contents change; 
+		 * encodes started for an older generation are dropped. */
+		unsigned int mContentGeneration;
+		
+		/** Value of mContentGeneration when the running encode was 
+		 * started. */
+		unsigned int mEncodeGeneration;
+		
+		/** Material and name of the UI texture as of the last 
+		 * resizeTexture(). */
+		Ogre::MaterialPtr mMaterial;
+		std::string mTextureName;
+		
+		/** @see isCompressedTextureShown() */
+		bool mCompressedTextureShown;
+		
+		/** @return The proxy item of aWidget. If aCreate is set 
+		 * and aWidget is a descendant of the active widget without 
+		 * a proxy, a proxy is created for it. */
+		CachedProxyWidget* getProxy(QWidget *aWidget, bool aCreate) const;
+		
+		/** Displays the uncompressed texture aTexture again if the 
+		 * compressed one is shown. */
+		void showUncompressedTexture(const Ogre::TexturePtr &aTexture);
+		
+		/** Removes the compressed texture, if any. */
+		void removeCompressedTexture();
+		
+		/** @see setVirtualResolution() */
+		QSize mVirtualResolution;
+		
+		/** @see setRenderScale() */
+		qreal mRenderScale;
+		
+		/** Size of the render window as of the last resize. */
+		QSize mWindowSize;
+		
+		/** Maps aPoint from window to layout coordinates, i.e. to 
+		 * the coordinates of the active widget. */
+		QPoint mapToLayout(const QPoint &aPoint) const;
+		
+		/** With Enums::UiBackendDirectWidget: @return The widget 
+		 * at aPos in the active widget's coordinates. */
+		QWidget* widgetAt(const QPoint &aPos) const;
+		
+		/** With Enums::UiBackendDirectWidget: Sends a copy of 
+		 * aEvent to aTarget with its position at aPos in the active 
+		 * widget's coordinates. */
+		void sendMouseEvent(QWidget *aTarget, const QMouseEvent *aEvent, const QPoint &aPos);
+		
+		/** With Enums::UiBackendDirectWidget: Sends enter and leave 
+		 * events if the widget under the cursor changed. */
+		void updateHoveredWidget(QWidget *aWidget);
+		
+		/** Maps aPoint from window to view coordinates. */
+		QPoint mapFromWindow(const QPoint &aPoint) const;
+		
+		/** @return A copy of aEvent with its position mapped from 
+		 * window to view coordinates. */
+		QMouseEvent mapFromWindow(const QMouseEvent *aEvent) const;
+		
+		/** @see setParallelRendering() */
+		bool mParallelRendering;
+		
+		/** @see getLastRenderBandCount() */
+		int mLastRenderBandCount;
+		
+		/** Totals of the prewarm calls. 
+		 * @see logPrewarmStatistics() */
+		int mPrewarmedWidgets;
+		int mPrewarmedCharacters;
+		QSet<QString> mPrewarmedFonts;
+		int mPrewarmTime;
+		
+		/** Scene manager whose overlay group latches the UI 
+		 * texture. Null if late latching is disabled. 
+		 * @see setLateLatching() */
+		Ogre::SceneManager *mLateLatchSceneManager;
+		
+		/** UI texture updated by late latching. */
+		Ogre::TexturePtr mLateLatchTexture;
+		
+		/** Drives Qt's animations. Null if the frame clock is 
+		 * disabled. Owned by us. */
+		FrameAnimationDriver *mAnimationDriver;
+		
+		/** @see setMaxRepaintRate() */
+		int mMaxRepaintRate;
+		
+		/** Timestamp passed to the last advanceFrame(). */
+		qint64 mFrameTime;
+		
+		/** Frame timestamp of the last repaint or -1. */
+		qint64 mLastRepaintTime;
+		
+		/** @see getCommandQueue() */
+		UiCommandQueue mCommandQueue;
+		
+		/** @see getDataBinder() */
+		DataBinder mDataBinder;
+		
+		/** @see retainWidget() */
+		QSet<QWidget *> mRetainedWidgets;
+		
+		/** Renders the UI into mLateLatchTexture if it is dirty. */
+		void latchTexture();
+		
+		/** Rasterizes the render size of the UI into mTextureImage 
+		 * and uploads the tiles which differ from the previous frame. */
+		void renderChangedTiles(const Ogre::TexturePtr &aTexture);
+		
+		/** (Re)allocates mTextureImage with size aSize. */
+		void prepareTextureImage(const QSize &aSize);
+		
+		/** Clears aTarget and renders mWidgetView into it, in 
+		 * parallel bands if possible. */
+		void rasterize(QImage &aTarget);
+		
+		/** Renders all items into aTarget in horizontal bands, the 
+		 * thread-safe ones on the global thread pool.
+		 * @return False, if no item is thread-safe or the scene 
+		 * uses features the bands cannot reproduce; aTarget is 
+		 * left untouched in that case. */
+		bool rasterizeParallel(QImage &aTarget);
 	};
 }
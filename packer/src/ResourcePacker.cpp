@@ -0,0 +1,81 @@
+/** This file is part of Cutexture.
+ 
+ Copyright (c) 2010 Markus Weiland, Kevin Lang
+
+ Portions of this code may be under copyright of authors listed in AUTHORS.
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+#include "ResourcePack.h"
+
+#include <iostream>
+
+using namespace Cutexture;
+
+/** Packs all files below a directory into a ResourcePack, named 
+ * by their path relative to it. With -z, entries are compressed 
+ * where that pays off; uncompressed entries can be read without 
+ * copying.
+ * Usage: resource-packer [-z] <output pack> <input directory> */
+int main(int argc, char *argv[])
+{
+	QCoreApplication app(argc, argv);
+
+	QStringList arguments = app.arguments().mid(1);
+	const bool compress = arguments.removeAll("-z") > 0;
+
+	if (arguments.size() != 2)
+	{
+		std::cerr << "Usage: resource-packer [-z] <output pack> <input directory>" << std::endl;
+		return 1;
+	}
+
+	const QDir inputDir(arguments.at(1));
+	if (!inputDir.exists())
+	{
+		std::cerr << "No such directory: " << arguments.at(1).toStdString() << std::endl;
+		return 1;
+	}
+
+	ResourcePackWriter writer;
+
+	QDirIterator it(inputDir.path(), QDir::Files, QDirIterator::Subdirectories);
+	while (it.hasNext())
+	{
+		const QString fileName = it.next();
+		const QString entryName = inputDir.relativeFilePath(fileName);
+
+		if (!writer.addFile(entryName, fileName, compress))
+		{
+			std::cerr << "Cannot read " << fileName.toStdString() << std::endl;
+			return 1;
+		}
+	}
+
+	if (!writer.write(arguments.at(0)))
+	{
+		std::cerr << "Cannot write " << arguments.at(0).toStdString() << std::endl;
+		return 1;
+	}
+
+	std::cout << "Packed " << writer.getEntryCount() << " files into "
+			<< arguments.at(0).toStdString() << std::endl;
+	return 0;
+}
@@ -0,0 +1,295 @@
+/** This file is part of Cutexture.
+ 
+ Copyright (c) 2010 Markus Weiland, Kevin Lang
+
+ Portions of this code may be under copyright of authors listed in AUTHORS.
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+#include "BlockCompression.h"
+
+#include <climits>
+#include <cstring>
+
+namespace
+{
+	const int BC1_BLOCK_BYTES = 8;
+	const int BC3_BLOCK_BYTES = 16;
+	
+	inline quint16 toRgb565(int aRed, int aGreen, int aBlue)
+	{
+		return quint16(((aRed >> 3) << 11) | ((aGreen >> 2) << 5) | (aBlue >> 3));
+	}
+	
+	/** Expands a 565 colour to 8 bits per channel, as the decoder does. */
+	inline void fromRgb565(quint16 aColour, int *aRgb)
+	{
+		aRgb[0] = ((aColour >> 11) & 0x1f) * 255 / 31;
+		aRgb[1] = ((aColour >> 5) & 0x3f) * 255 / 63;
+		aRgb[2] = (aColour & 0x1f) * 255 / 31;
+	}
+	
+	/** Reads the 4x4 block at aX, aY. Pixels outside of the image 
+	 * repeat the last row or column. */
+	void readBlock(const QImage &aImage, int aX, int aY, QRgb *aBlock)
+	{
+		for (int y = 0; y < 4; ++y)
+		{
+			const QRgb *row = reinterpret_cast<const QRgb *> (aImage.constScanLine(qMin(aY + y,
+					aImage.height() - 1)));
+			for (int x = 0; x < 4; ++x)
+			{
+				aBlock[y * 4 + x] = row[qMin(aX + x, aImage.width() - 1)];
+			}
+		}
+	}
+	
+	void writeLittleEndian16(uchar *aTarget, quint16 aValue)
+	{
+		aTarget[0] = uchar(aValue);
+		aTarget[1] = uchar(aValue >> 8);
+	}
+	
+	/** Writes the 8 byte BC1 colour block for aBlock. Always uses the 
+	 * four colour mode, which is also the only one allowed in BC3. */
+	void encodeColourBlock(const QRgb *aBlock, uchar *aTarget)
+	{
+		int minRgb[3] = { 255, 255, 255 };
+		int maxRgb[3] = { 0, 0, 0 };
+		
+		for (int i = 0; i < 16; ++i)
+		{
+			const int rgb[3] = { qRed(aBlock[i]), qGreen(aBlock[i]), qBlue(aBlock[i]) };
+			for (int c = 0; c < 3; ++c)
+			{
+				minRgb[c] = qMin(minRgb[c], rgb[c]);
+				maxRgb[c] = qMax(maxRgb[c], rgb[c]);
+			}
+		}
+		
+		// inset the bounding box to reduce the error of the end points
+		for (int c = 0; c < 3; ++c)
+		{
+			const int inset = (maxRgb[c] - minRgb[c]) >> 4;
+			minRgb[c] += inset;
+			maxRgb[c] -= inset;
+		}
+		
+		quint16 colour0 = toRgb565(maxRgb[0], maxRgb[1], maxRgb[2]);
+		quint16 colour1 = toRgb565(minRgb[0], minRgb[1], minRgb[2]);
+		
+		if (colour0 < colour1)
+		{
+			qSwap(colour0, colour1);
+		}
+		
+		quint32 indices = 0;
+		
+		// equal end points would select the three colour mode; index 0 is correct for all pixels
+		if (colour0 != colour1)
+		{
+			int palette[4][3];
+			fromRgb565(colour0, palette[0]);
+			fromRgb565(colour1, palette[1]);
+			for (int c = 0; c < 3; ++c)
+			{
+				palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+				palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+			}
+			
+			for (int i = 0; i < 16; ++i)
+			{
+				const int rgb[3] = { qRed(aBlock[i]), qGreen(aBlock[i]), qBlue(aBlock[i]) };
+				int bestIndex = 0;
+				int bestError = INT_MAX;
+				
+				for (int p = 0; p < 4; ++p)
+				{
+					const int dr = rgb[0] - palette[p][0];
+					const int dg = rgb[1] - palette[p][1];
+					const int db = rgb[2] - palette[p][2];
+					const int error = dr * dr + dg * dg + db * db;
+					if (error < bestError)
+					{
+						bestError = error;
+						bestIndex = p;
+					}
+				}
+				
+				indices |= quint32(bestIndex) << (i * 2);
+			}
+		}
+		
+		writeLittleEndian16(aTarget, colour0);
+		writeLittleEndian16(aTarget + 2, colour1);
+		aTarget[4] = uchar(indices);
+		aTarget[5] = uchar(indices >> 8);
+		aTarget[6] = uchar(indices >> 16);
+		aTarget[7] = uchar(indices >> 24);
+	}
+	
+	/** Writes the 8 byte BC3 alpha block for aBlock, using the eight 
+	 * value mode. */
+	void encodeAlphaBlock(const QRgb *aBlock, uchar *aTarget)
+	{
+		int minAlpha = 255;
+		int maxAlpha = 0;
+		
+		for (int i = 0; i < 16; ++i)
+		{
+			minAlpha = qMin(minAlpha, qAlpha(aBlock[i]));
+			maxAlpha = qMax(maxAlpha, qAlpha(aBlock[i]));
+		}
+		
+		quint64 indices = 0;
+		
+		if (maxAlpha != minAlpha)
+		{
+			int palette[8];
+			palette[0] = maxAlpha;
+			palette[1] = minAlpha;
+			for (int p = 2; p < 8; ++p)
+			{
+				palette[p] = ((8 - p) * maxAlpha + (p - 1) * minAlpha) / 7;
+			}
+			
+			for (int i = 0; i < 16; ++i)
+			{
+				const int alpha = qAlpha(aBlock[i]);
+				int bestIndex = 0;
+				int bestError = INT_MAX;
+				
+				for (int p = 0; p < 8; ++p)
+				{
+					const int error = qAbs(alpha - palette[p]);
+					if (error < bestError)
+					{
+						bestError = error;
+						bestIndex = p;
+					}
+				}
+				
+				indices |= quint64(bestIndex) << (i * 3);
+			}
+		}
+		
+		aTarget[0] = uchar(maxAlpha);
+		aTarget[1] = uchar(minAlpha);
+		for (int b = 0; b < 6; ++b)
+		{
+			aTarget[2 + b] = uchar(indices >> (b * 8));
+		}
+	}
+	
+	/** Writes a transparent black block. BC1 uses the three colour 
+	 * mode (equal end points) whose fourth index is transparent. */
+	void writePaddingBlock(bool aBc1, uchar *aTarget)
+	{
+		if (aBc1)
+		{
+			memset(aTarget, 0, 4);
+			memset(aTarget + 4, 0xff, 4);
+		}
+		else
+		{
+			memset(aTarget, 0, BC3_BLOCK_BYTES);
+		}
+	}
+	
+	bool isOpaque(const QImage &aImage)
+	{
+		for (int y = 0; y < aImage.height(); ++y)
+		{
+			const QRgb *row = reinterpret_cast<const QRgb *> (aImage.constScanLine(y));
+			for (int x = 0; x < aImage.width(); ++x)
+			{
+				if (qAlpha(row[x]) != 255)
+				{
+					return false;
+				}
+			}
+		}
+		
+		return true;
+	}
+}
+
+namespace Cutexture
+{
+	namespace Utility
+	{
+		CompressedImage compressImage(const QImage &aImage, const QSize &aSize)
+		{
+			assert(aImage.format() == QImage::Format_ARGB32);
+			assert(aImage.width() <= aSize.width() && aImage.height() <= aSize.height());
+			
+			CompressedImage result;
+			
+			if (aImage.isNull())
+			{
+				return result;
+			}
+			
+			// the padding is transparent in both formats and doesn't count against BC1
+			const bool opaque = isOpaque(aImage);
+			const int blockBytes = opaque ? BC1_BLOCK_BYTES : BC3_BLOCK_BYTES;
+			const int imageBlocksX = (aImage.width() + 3) / 4;
+			const int imageBlocksY = (aImage.height() + 3) / 4;
+			const int blocksX = (aSize.width() + 3) / 4;
+			const int blocksY = (aSize.height() + 3) / 4;
+			
+			result.format = opaque ? Ogre::PF_DXT1 : Ogre::PF_DXT5;
+			result.size = aSize;
+			result.data.resize(blocksX * blocksY * blockBytes);
+			
+			uchar *target = reinterpret_cast<uchar *> (result.data.data());
+			QRgb block[16];
+			
+			for (int blockY = 0; blockY < blocksY; ++blockY)
+			{
+				for (int blockX = 0; blockX < blocksX; ++blockX)
+				{
+					if (blockX >= imageBlocksX || blockY >= imageBlocksY)
+					{
+						writePaddingBlock(opaque, target);
+					}
+					else
+					{
+						readBlock(aImage, blockX * 4, blockY * 4, block);
+						
+						if (opaque)
+						{
+							encodeColourBlock(block, target);
+						}
+						else
+						{
+							encodeAlphaBlock(block, target);
+							encodeColourBlock(block, target + 8);
+						}
+					}
+					
+					target += blockBytes;
+				}
+			}
+			
+			return result;
+		}
+	}
+}
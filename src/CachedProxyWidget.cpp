@@ -0,0 +1,115 @@
+/** This file is part of Cutexture.
+ 
+ Copyright (c) 2010 Markus Weiland, Kevin Lang
+
+ Portions of this code may be under copyright of authors listed in AUTHORS.
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+#include "CachedProxyWidget.h"
+
+namespace Cutexture
+{
+	CachedProxyWidget::CachedProxyWidget(QGraphicsItem *aParent) :
+		QGraphicsProxyWidget(aParent), mWidgetCacheMode(Enums::WidgetCacheNone),
+				mPictureValid(false)
+	{
+	}
+	
+	CachedProxyWidget::~CachedProxyWidget()
+	{
+	}
+	
+	void CachedProxyWidget::setWidgetCacheMode(Enums::WidgetCacheMode aMode)
+	{
+		mWidgetCacheMode = aMode;
+		
+		setCacheMode(aMode == Enums::WidgetCachePixmap ? QGraphicsItem::DeviceCoordinateCache
+				: QGraphicsItem::NoCache);
+		invalidateCache();
+	}
+	
+	void CachedProxyWidget::invalidateCache()
+	{
+		mPicture = QPicture();
+		mPictureValid = false;
+		
+		// also invalidates the pixmap cache
+		update();
+	}
+	
+	void CachedProxyWidget::paint(QPainter *aPainter, const QStyleOptionGraphicsItem *aOption,
+			QWidget *aWidget)
+	{
+		if (mWidgetCacheMode != Enums::WidgetCachePicture)
+		{
+			QGraphicsProxyWidget::paint(aPainter, aOption, aWidget);
+			return;
+		}
+		
+		if (!mPictureValid)
+		{
+			// record the whole widget, not only the exposed part
+			QStyleOptionGraphicsItem recordOption(*aOption);
+			recordOption.exposedRect = boundingRect();
+			
+			QPainter recorder(&mPicture);
+			QGraphicsProxyWidget::paint(&recorder, &recordOption, aWidget);
+			recorder.end();
+			
+			mPictureValid = true;
+		}
+		
+		aPainter->save();
+		aPainter->setClipRect(aOption->exposedRect, Qt::IntersectClip);
+		aPainter->drawPicture(0, 0, mPicture);
+		aPainter->restore();
+	}
+	
+	bool CachedProxyWidget::eventFilter(QObject *aObject, QEvent *aEvent)
+	{
+		if (aObject == widget() && mWidgetCacheMode == Enums::WidgetCachePicture)
+		{
+			switch (aEvent->type())
+			{
+			case QEvent::Resize:
+			case QEvent::StyleChange:
+			case QEvent::FontChange:
+			case QEvent::PaletteChange:
+			case QEvent::EnabledChange:
+			case QEvent::LanguageChange:
+			case QEvent::ChildAdded:
+			case QEvent::ChildRemoved:
+				invalidateCache();
+				break;
+			default:
+				break;
+			}
+		}
+		
+		return QGraphicsProxyWidget::eventFilter(aObject, aEvent);
+	}
+	
+	QGraphicsProxyWidget* CachedProxyWidget::newProxyWidget(const QWidget *aChild)
+	{
+		Q_UNUSED(aChild);
+		return new CachedProxyWidget(this);
+	}
+}
@@ -0,0 +1,287 @@
+/** This file is part of Cutexture.
+ 
+ Copyright (c) 2010 Markus Weiland, Kevin Lang
+
+ Portions of this code may be under copyright of authors listed in AUTHORS.
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+#include "CursorLayer.h"
+#include "Constants.h"
+
+namespace Cutexture
+{
+	CursorLayer::CursorLayer(Ogre::SceneManager *aSceneManager, const Ogre::String &aName) :
+		mSceneManager(aSceneManager), mQuad(NULL), mNode(NULL), mCurrentShape(-1),
+				mCurrentPixmapKey(0), mVisible(true), mBlank(false)
+	{
+		assert(aSceneManager);
+		
+		mTexture = Ogre::TextureManager::getSingleton().createManual(aName,
+				Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME, Ogre::TEX_TYPE_2D,
+				Constants::CURSOR_TEXTURE_SIZE, Constants::CURSOR_TEXTURE_SIZE, 0,
+				Ogre::PF_A8R8G8B8, Ogre::TU_DYNAMIC_WRITE_ONLY);
+		
+		mMaterial = Ogre::MaterialManager::getSingleton().create(aName,
+				Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+		Ogre::Pass *pass = mMaterial->getTechnique(0)->getPass(0);
+		pass->setLightingEnabled(false);
+		pass->setDepthCheckEnabled(false);
+		pass->setDepthWriteEnabled(false);
+		pass->setSceneBlending(Ogre::SBT_TRANSPARENT_ALPHA);
+		Ogre::TextureUnitState *textureUnit = pass->createTextureUnitState(aName);
+		textureUnit->setTextureFiltering(Ogre::TFO_NONE);
+		textureUnit->setTextureAddressingMode(Ogre::TextureUnitState::TAM_CLAMP);
+		
+		mQuad = new Ogre::Rectangle2D(true);
+		mQuad->setBoundingBox(Ogre::AxisAlignedBox(-100000.0 * Ogre::Vector3::UNIT_SCALE,
+				100000.0 * Ogre::Vector3::UNIT_SCALE));
+		// drawn after everything else, including the UI overlay
+		mQuad->setRenderQueueGroup(Ogre::RENDER_QUEUE_MAX);
+		mQuad->setMaterial(aName);
+		mQuad->setVisible(false);
+		
+		mNode = mSceneManager->getRootSceneNode()->createChildSceneNode();
+		mNode->attachObject(mQuad);
+		
+		setCursor(QCursor(Qt::ArrowCursor));
+	}
+	
+	CursorLayer::~CursorLayer()
+	{
+		mNode->detachAllObjects();
+		mSceneManager->destroySceneNode(mNode);
+		delete mQuad;
+		
+		Ogre::MaterialManager::getSingleton().remove(mMaterial->getHandle());
+		Ogre::TextureManager::getSingleton().remove(mTexture->getHandle());
+	}
+	
+	void CursorLayer::setCursorImage(Qt::CursorShape aShape, const QImage &aImage, const QPoint &aHotSpot)
+	{
+		CursorImage cursorImage;
+		cursorImage.image = aImage.convertToFormat(QImage::Format_ARGB32);
+		cursorImage.hotSpot = aHotSpot;
+		mCursorImages.insert(aShape, cursorImage);
+		
+		// force an upload if the shape is shown right now
+		if (aShape == mCurrentShape)
+		{
+			mCurrentShape = -1;
+			setCursor(QCursor(aShape));
+		}
+	}
+	
+	void CursorLayer::setCursor(const QCursor &aCursor)
+	{
+		const Qt::CursorShape shape = aCursor.shape();
+		
+		mBlank = (shape == Qt::BlankCursor);
+		if (mBlank)
+		{
+			updateVisibility();
+			return;
+		}
+		
+		if (shape == Qt::BitmapCursor)
+		{
+			const QPixmap pixmap = aCursor.pixmap();
+			if (shape == mCurrentShape && pixmap.cacheKey() == mCurrentPixmapKey)
+			{
+				updateVisibility();
+				return;
+			}
+			
+			upload(pixmap.toImage().convertToFormat(QImage::Format_ARGB32));
+			mHotSpot = aCursor.hotSpot();
+			mCurrentPixmapKey = pixmap.cacheKey();
+		}
+		else
+		{
+			if (shape == mCurrentShape)
+			{
+				updateVisibility();
+				return;
+			}
+			
+			if (!mCursorImages.contains(shape))
+			{
+				CursorImage cursorImage;
+				cursorImage.image = createDefaultImage(shape, cursorImage.hotSpot);
+				
+				// shapes without an image are shown as an arrow
+				if (cursorImage.image.isNull())
+				{
+					cursorImage.image = createDefaultImage(Qt::ArrowCursor, cursorImage.hotSpot);
+				}
+				mCursorImages.insert(shape, cursorImage);
+			}
+			
+			const CursorImage &cursorImage = mCursorImages[shape];
+			upload(cursorImage.image);
+			mHotSpot = cursorImage.hotSpot;
+		}
+		
+		mCurrentShape = shape;
+		updateQuad();
+		updateVisibility();
+	}
+	
+	void CursorLayer::setPosition(const QPoint &aPosition, const QSize &aWindowSize)
+	{
+		if (aPosition == mPosition && aWindowSize == mWindowSize)
+		{
+			return;
+		}
+		
+		mPosition = aPosition;
+		mWindowSize = aWindowSize;
+		updateQuad();
+		updateVisibility();
+	}
+	
+	void CursorLayer::setVisible(bool aVisible)
+	{
+		mVisible = aVisible;
+		updateVisibility();
+	}
+	
+	void CursorLayer::upload(const QImage &aImage)
+	{
+		assert(aImage.format() == QImage::Format_ARGB32);
+		
+		Ogre::HardwarePixelBufferSharedPtr hwBuffer = mTexture->getBuffer(0, 0);
+		hwBuffer->lock(Ogre::HardwareBuffer::HBL_DISCARD);
+		
+		const Ogre::PixelBox &pb = hwBuffer->getCurrentLock();
+		QImage textureImg((uchar *)pb.data, pb.getWidth(), pb.getHeight(), pb.rowPitch * 4,
+				QImage::Format_ARGB32);
+		textureImg.fill(0);
+		
+		QPainter painter(&textureImg);
+		painter.setCompositionMode(QPainter::CompositionMode_Source);
+		painter.drawImage(0, 0, aImage);
+		painter.end();
+		
+		hwBuffer->unlock();
+	}
+	
+	void CursorLayer::updateQuad()
+	{
+		if (mWindowSize.isEmpty())
+		{
+			return;
+		}
+		
+		// the quad covers the whole texture, the image is in its top left corner
+		const QPoint topLeft = mPosition - mHotSpot;
+		const Ogre::Real left = Ogre::Real(topLeft.x()) / mWindowSize.width();
+		const Ogre::Real top = Ogre::Real(topLeft.y()) / mWindowSize.height();
+		const Ogre::Real right = Ogre::Real(topLeft.x() + Constants::CURSOR_TEXTURE_SIZE)
+				/ mWindowSize.width();
+		const Ogre::Real bottom = Ogre::Real(topLeft.y() + Constants::CURSOR_TEXTURE_SIZE)
+				/ mWindowSize.height();
+		
+		mQuad->setCorners(left * 2 - 1, 1 - top * 2, right * 2 - 1, 1 - bottom * 2);
+	}
+	
+	void CursorLayer::updateVisibility()
+	{
+		mQuad->setVisible(mVisible && !mBlank && !mWindowSize.isEmpty());
+	}
+	
+	QImage CursorLayer::createDefaultImage(Qt::CursorShape aShape, QPoint &aHotSpot)
+	{
+		QImage image(Constants::CURSOR_TEXTURE_SIZE, Constants::CURSOR_TEXTURE_SIZE,
+				QImage::Format_ARGB32);
+		image.fill(0);
+		
+		QPainter painter(&image);
+		painter.setRenderHint(QPainter::Antialiasing);
+		painter.setPen(QPen(Qt::black, 1));
+		painter.setBrush(Qt::white);
+		
+		switch (aShape)
+		{
+			case Qt::ArrowCursor:
+			{
+				static const QPointF arrow[] = { QPointF(0.5, 0.5), QPointF(0.5, 17.5), QPointF(
+						4.5, 13.5), QPointF(7.5, 20.5), QPointF(10.5, 19.5), QPointF(7.5, 12.5),
+						QPointF(12.5, 12.5) };
+				painter.drawPolygon(arrow, sizeof(arrow) / sizeof(arrow[0]));
+				aHotSpot = QPoint(0, 0);
+				break;
+			}
+			case Qt::IBeamCursor:
+			{
+				// white outline for contrast on dark backgrounds
+				painter.setRenderHint(QPainter::Antialiasing, false);
+				painter.setPen(QPen(Qt::white, 3));
+				painter.drawLine(4, 1, 4, 17);
+				painter.drawLine(1, 1, 7, 1);
+				painter.drawLine(1, 17, 7, 17);
+				painter.setPen(QPen(Qt::black, 1));
+				painter.drawLine(4, 1, 4, 17);
+				painter.drawLine(2, 1, 6, 1);
+				painter.drawLine(2, 17, 6, 17);
+				aHotSpot = QPoint(4, 9);
+				break;
+			}
+			case Qt::CrossCursor:
+			{
+				painter.setRenderHint(QPainter::Antialiasing, false);
+				painter.setPen(QPen(Qt::white, 3));
+				painter.drawLine(1, 10, 19, 10);
+				painter.drawLine(10, 1, 10, 19);
+				painter.setPen(QPen(Qt::black, 1));
+				painter.drawLine(1, 10, 19, 10);
+				painter.drawLine(10, 1, 10, 19);
+				aHotSpot = QPoint(10, 10);
+				break;
+			}
+			case Qt::SizeHorCursor:
+			case Qt::SplitHCursor:
+			{
+				static const QPointF arrow[] = { QPointF(0.5, 8.5), QPointF(5.5, 3.5), QPointF(
+						5.5, 6.5), QPointF(14.5, 6.5), QPointF(14.5, 3.5), QPointF(19.5, 8.5),
+						QPointF(14.5, 13.5), QPointF(14.5, 10.5), QPointF(5.5, 10.5), QPointF(5.5,
+								13.5) };
+				painter.drawPolygon(arrow, sizeof(arrow) / sizeof(arrow[0]));
+				aHotSpot = QPoint(10, 8);
+				break;
+			}
+			case Qt::SizeVerCursor:
+			case Qt::SplitVCursor:
+			{
+				static const QPointF arrow[] = { QPointF(8.5, 0.5), QPointF(13.5, 5.5), QPointF(
+						10.5, 5.5), QPointF(10.5, 14.5), QPointF(13.5, 14.5), QPointF(8.5, 19.5),
+						QPointF(3.5, 14.5), QPointF(6.5, 14.5), QPointF(6.5, 5.5), QPointF(3.5,
+								5.5) };
+				painter.drawPolygon(arrow, sizeof(arrow) / sizeof(arrow[0]));
+				aHotSpot = QPoint(8, 10);
+				break;
+			}
+			default:
+				return QImage();
+		}
+		
+		return image;
+	}
+}
@@ -0,0 +1,202 @@
+/** This file is part of Cutexture.
+ 
+ Copyright (c) 2010 Markus Weiland, Kevin Lang
+
+ Portions of this code may be under copyright of authors listed in AUTHORS.
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+#include "DataBinder.h"
+#include "Exception.h"
+
+namespace Cutexture
+{
+	DataBinder::DataBinder() :
+		mTransactionDepth(0), mPendingChanges(false)
+	{
+	}
+	
+	DataBinder::~DataBinder()
+	{
+	}
+	
+	void DataBinder::setRoot(QObject *aRoot)
+	{
+		if (mRoot == aRoot)
+		{
+			return;
+		}
+		
+		mRoot = aRoot;
+		
+		// the new widgets have never seen any of the values
+		for (QHash<QString, Binding>::iterator it = mBindings.begin(); it != mBindings.end(); ++it)
+		{
+			it->target = NULL;
+			it->appliedValue = QVariant();
+			it->changed = it->value.isValid();
+			mPendingChanges |= it->changed;
+		}
+	}
+	
+	void DataBinder::bind(const QString &aKey, const QString &aObjectName, const char *aProperty)
+	{
+		assert(aProperty);
+		
+		Binding binding;
+		binding.objectName = aObjectName;
+		binding.property = aProperty;
+		binding.changed = false;
+		
+		QHash<QString, Binding>::const_iterator existing = mBindings.constFind(aKey);
+		if (existing != mBindings.constEnd())
+		{
+			binding.value = existing->value;
+			binding.changed = binding.value.isValid();
+			mPendingChanges |= binding.changed;
+		}
+		
+		mBindings.insert(aKey, binding);
+	}
+	
+	void DataBinder::unbind(const QString &aKey)
+	{
+		mBindings.remove(aKey);
+	}
+	
+	void DataBinder::begin()
+	{
+		++mTransactionDepth;
+	}
+	
+	int DataBinder::commit()
+	{
+		assert(mTransactionDepth > 0);
+		
+		if (--mTransactionDepth > 0 || !mPendingChanges)
+		{
+			return 0;
+		}
+		
+		return applyChanges();
+	}
+	
+	void DataBinder::setValue(const QString &aKey, const QVariant &aValue)
+	{
+		QHash<QString, Binding>::iterator it = mBindings.find(aKey);
+		if (it == mBindings.end())
+		{
+			EXCEPTION("No binding for value '" + aKey.toStdString() + "'.", "DataBinder::setValue()");
+		}
+		
+		it->value = aValue;
+		it->changed = (aValue != it->appliedValue || !it->target);
+		
+		if (!it->changed)
+		{
+			return;
+		}
+		
+		if (isInTransaction())
+		{
+			mPendingChanges = true;
+		}
+		else
+		{
+			applyBinding(*it);
+			
+			// the object may not exist yet
+			mPendingChanges |= it->changed;
+		}
+	}
+	
+	QVariant DataBinder::getValue(const QString &aKey) const
+	{
+		return mBindings.value(aKey).value;
+	}
+	
+	int DataBinder::applyChanges()
+	{
+		if (!mRoot)
+		{
+			return 0;
+		}
+		
+		mPendingChanges = false;
+		
+		// Qt merges the layout requests of all writes into one posted event
+		int written = 0;
+		for (QHash<QString, Binding>::iterator it = mBindings.begin(); it != mBindings.end(); ++it)
+		{
+			if (it->changed && applyBinding(*it))
+			{
+				++written;
+			}
+			
+			mPendingChanges |= it->changed;
+		}
+		
+		return written;
+	}
+	
+	bool DataBinder::applyBinding(Binding &aBinding)
+	{
+		if (!mRoot)
+		{
+			return false;
+		}
+		
+		if (!aBinding.target)
+		{
+			if (mRoot->objectName() == aBinding.objectName)
+			{
+				aBinding.target = mRoot;
+			}
+			else
+			{
+				aBinding.target = mRoot->findChild<QObject *> (aBinding.objectName);
+			}
+			
+			if (!aBinding.target)
+			{
+				// try again once the object exists
+				return false;
+			}
+			
+			aBinding.appliedValue = QVariant();
+		}
+		
+		aBinding.changed = false;
+		
+		if (aBinding.value == aBinding.appliedValue)
+		{
+			return false;
+		}
+		
+		if (!aBinding.target->setProperty(aBinding.property.constData(), aBinding.value))
+		{
+			qWarning() << "DataBinder: cannot set property" << aBinding.property << "of"
+					<< aBinding.objectName;
+		}
+		
+		aBinding.appliedValue = aBinding.value;
+		return true;
+	}
+}
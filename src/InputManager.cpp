@@ -24,15 +24,14 @@
  */
 
 #include "InputManager.h"
+#include "OisInputSource.h"
 #include "UiManager.h"
 #include "Exception.h"
-#include "Constants.h"
 
 namespace Cutexture
 {
 	InputManager::InputManager() :
-		mOis(NULL), mOisKeyboard(NULL), mOisMouse(NULL), mMouseButtonsPressed(0),
-				mModifiersPressed(0)
+		mEventSource(NULL), mInputRecorder(NULL), mMouseButtonsPressed(0), mModifiersPressed(0)
 	{
 		// set up keymap
 		mMovementKeys.insert(Qt::Key_W, Enums::Forward);
@@ -47,104 +46,73 @@ namespace Cutexture
 	
 	InputManager::~InputManager()
 	{
-		if (mOis)
-		{
-			if (mOisKeyboard)
-			{
-				mOis->destroyInputObject(mOisKeyboard);
-				mOisKeyboard = 0;
-			}
-
-			if (mOisMouse)
-			{
-				mOis->destroyInputObject(mOisMouse);
-				mOisMouse = 0;
-			}
-
-			OIS::InputManager::destroyInputSystem(mOis);
-			mOis = 0;
-		}
+		stopRecording();
+		
+		delete mEventSource;
+		mEventSource = 0;
+		
+		qDeleteAll(mInputEvents);
 	}
 	
-	void InputManager::initialize(Ogre::RenderWindow *aRenderWindow)
+	void InputManager::initialize(Ogre::RenderWindow *aRenderWindow, bool aHideSystemCursor)
+	{
+		QScopedPointer<OisInputSource> oisSource(new OisInputSource());
+		oisSource->initialize(aRenderWindow, aHideSystemCursor);
+		
+		initialize(oisSource.take());
+	}
+	
+	void InputManager::initialize(InputEventSource *aEventSource)
 	{
 		// initialize only once
-		assert(!mOis);
+		assert(!mEventSource);
+		assert(aEventSource);
 		
-		// initialize the OpenInputSystem (OIS)
-		size_t windowHnd = 0;
-		aRenderWindow->getCustomAttribute("WINDOW", &windowHnd);
-		std::ostringstream windowHndStr;
-		windowHndStr << windowHnd;
-		OIS::ParamList paramList;
-		paramList.insert(std::make_pair(std::string("WINDOW"), windowHndStr.str()));
-#if defined(OIS_WIN32_PLATFORM)
-		// if activated, can break absolute mouse positioning
-		// TODO test if this works correctly with foreground and nonexclusive flags active
-		paramList.insert(std::make_pair(std::string("w32_mouse"), std::string("DISCL_FOREGROUND" )));
-		paramList.insert(std::make_pair(std::string("w32_mouse"), std::string("DISCL_NONEXCLUSIVE")));
-		//		paramList.insert(std::make_pair(std::string("w32_keyboard"), std::string("DISCL_FOREGROUND")));
-		//		paramList.insert(std::make_pair(std::string("w32_keyboard"), std::string("DISCL_NONEXCLUSIVE")));
-#elif defined(OIS_LINUX_PLATFORM)
-		paramList.insert(std::make_pair(std::string("x11_mouse_grab"), std::string("false")));
-		paramList.insert(std::make_pair(std::string("x11_mouse_hide"), std::string("false")));
-		paramList.insert(std::make_pair(std::string("x11_keyboard_grab"), std::string("false")));
-		paramList.insert(std::make_pair(std::string("XAutoRepeatOn"), std::string("true")));
-#endif
-		mOis = OIS::InputManager::createInputSystem(paramList);
+		mEventSource = aEventSource;
+		mEventSource->setEventCallbacks(this, this);
+	}
+	
+	void InputManager::updateInputState()
+	{
+		assert(mEventSource);
 		
-		try
-		{
-			mOisKeyboard = static_cast<OIS::Keyboard*> (mOis->createInputObject(OIS::OISKeyboard,
-					true));
-			mOisKeyboard->setEventCallback(this);
-			mOisKeyboard->setTextTranslation(OIS::Keyboard::Unicode);
-		}
-		catch (...)
-		{
-			EXCEPTION("Could not initialize keyboard", "InputManager::InputManager()");
-		}
+		// set new state
+		mEventSource->capture();
 		
-		try
+		if (mInputRecorder)
 		{
-			mOisMouse = static_cast<OIS::Mouse*> (mOis->createInputObject(OIS::OISMouse, true));
-			
-			
-			//Set mouse clipping area
-			unsigned int width, height, depth;
-			int left, top;
-			
-			aRenderWindow->getMetrics(width, height, depth, left, top);
-			mOisMouse->getMouseState().width = width;
-			mOisMouse->getMouseState().height = height;
-			mOisMouse->setEventCallback(this);
-		}
-		catch (...)
-		{
-			EXCEPTION("Could not initialize mouse", "InputManager::InputManager()");
+			mInputRecorder->recordFrame(mEventSource->getMouseState());
 		}
 	}
 	
-	void InputManager::updateInputState()
+	void InputManager::startRecording(const QString &aFileName)
 	{
-		assert(mOis && mOisKeyboard && mOisMouse);
+		stopRecording();
 		
-		// set new state
-		mOisKeyboard->capture();
-		mOisMouse->capture();
+		mInputRecorder = new InputRecorder(aFileName);
+	}
+	
+	void InputManager::stopRecording()
+	{
+		delete mInputRecorder;
+		mInputRecorder = NULL;
 	}
 	
 	void InputManager::resizeEvent(QResizeEvent *event)
 	{
 		// update allowed mouse area
-		const OIS::MouseState &mouseState = mOisMouse->getMouseState();
-		mouseState.width = event->size().width();
-		mouseState.height = event->size().height();
+		mEventSource->setMouseArea(event->size().width(), event->size().height());
+	}
+	
+	QPoint InputManager::getMousePosition() const
+	{
+		const OIS::MouseState& mouseState = mEventSource->getMouseState();
+		return QPoint(mouseState.X.abs, mouseState.Y.abs);
 	}
 	
 	QPoint InputManager::getRelativeMouseMovement() const
 	{
-		const OIS::MouseState& mouseState = mOisMouse->getMouseState();
+		const OIS::MouseState& mouseState = mEventSource->getMouseState();
 		return QPoint(mouseState.X.rel, mouseState.Y.rel);
 	}
 	
@@ -181,9 +149,12 @@ namespace Cutexture
 	
 	bool InputManager::mouseMoved(const OIS::MouseEvent &arg)
 	{
+		if (mInputRecorder)
+		{
+			mInputRecorder->recordMouseEvent(InputRecording::MouseMoved, arg);
+		}
+		
 		QPoint eventPoint(arg.state.X.abs, arg.state.Y.abs);
-		eventPoint += QPoint(Constants::INPUT_MANAGER_MOUSE_OFFSET_X,
-				Constants::INPUT_MANAGER_MOUSE_OFFSET_Y);
 		//		qDebug() << "mouseMoved" << eventPoint;
 
 		QMouseEvent *mouseEvent = new QMouseEvent(QEvent::MouseMove, eventPoint, eventPoint, Qt::NoButton,
@@ -195,9 +166,12 @@ namespace Cutexture
 	
 	bool InputManager::mousePressed(const OIS::MouseEvent &arg, OIS::MouseButtonID id)
 	{
+		if (mInputRecorder)
+		{
+			mInputRecorder->recordMouseEvent(InputRecording::MousePressed, arg, id);
+		}
+		
 		QPoint eventPoint(arg.state.X.abs, arg.state.Y.abs);
-		eventPoint += QPoint(Constants::INPUT_MANAGER_MOUSE_OFFSET_X,
-				Constants::INPUT_MANAGER_MOUSE_OFFSET_Y);
 		//		qDebug() << "mousePressed" << eventPoint;
 
 		mMouseButtonsPressed |= toQtMouseButton(id);
@@ -211,9 +185,12 @@ namespace Cutexture
 	
 	bool InputManager::mouseReleased(const OIS::MouseEvent &arg, OIS::MouseButtonID id)
 	{
+		if (mInputRecorder)
+		{
+			mInputRecorder->recordMouseEvent(InputRecording::MouseReleased, arg, id);
+		}
+		
 		QPoint eventPoint(arg.state.X.abs, arg.state.Y.abs);
-		eventPoint += QPoint(Constants::INPUT_MANAGER_MOUSE_OFFSET_X,
-				Constants::INPUT_MANAGER_MOUSE_OFFSET_Y);
 		//		qDebug() << "mouseReleased" << eventPoint;
 
 		mMouseButtonsPressed &= ~Qt::MouseButtons(toQtMouseButton(id));
@@ -229,6 +206,11 @@ namespace Cutexture
 	
 	bool InputManager::keyPressed(const OIS::KeyEvent &arg)
 	{
+		if (mInputRecorder)
+		{
+			mInputRecorder->recordKeyEvent(InputRecording::KeyPressed, arg);
+		}
+		
 		Qt::KeyboardModifier modKey = toQtModifier(arg);
 		
 		if (modKey != Qt::NoModifier)
@@ -254,6 +236,11 @@ namespace Cutexture
 	
 	bool InputManager::keyReleased(const OIS::KeyEvent &arg)
 	{
+		if (mInputRecorder)
+		{
+			mInputRecorder->recordKeyEvent(InputRecording::KeyReleased, arg);
+		}
+		
 		Qt::KeyboardModifier modKey = toQtModifier(arg);
 		Qt::Key releasedKey = toQtKey(arg);
 		
@@ -0,0 +1,76 @@
+/** This file is part of Cutexture.
+ 
+ Copyright (c) 2010 Markus Weiland, Kevin Lang
+
+ Portions of this code may be under copyright of authors listed in AUTHORS.
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+#include "InputRecorder.h"
+#include "Exception.h"
+
+namespace Cutexture
+{
+	InputRecorder::InputRecorder(const QString &aFileName) :
+		mFile(aFileName), mFrameIndex(0)
+	{
+		if (!mFile.open(QFile::WriteOnly | QFile::Truncate))
+		{
+			EXCEPTION("Could not open input recording file " + aFileName.toStdString() + ".",
+					"InputRecorder::InputRecorder()");
+		}
+
+		mStream.setDevice(&mFile);
+		mStream << InputRecording::MAGIC << InputRecording::VERSION;
+	}
+
+	InputRecorder::~InputRecorder()
+	{
+		mStream.setDevice(NULL);
+		mFile.close();
+	}
+
+	void InputRecorder::recordMouseEvent(InputRecording::RecordType aType,
+			const OIS::MouseEvent &aEvent, OIS::MouseButtonID aButton)
+	{
+		mStream << quint8(aType);
+		InputRecording::writeMouseState(mStream, aEvent.state);
+		mStream << quint8(aButton);
+	}
+
+	void InputRecorder::recordKeyEvent(InputRecording::RecordType aType, const OIS::KeyEvent &aEvent)
+	{
+		mStream << quint8(aType) << quint8(aEvent.key) << quint32(aEvent.text);
+	}
+
+	void InputRecorder::recordFrame(const OIS::MouseState &aMouseState)
+	{
+		// timestamps are relative to the end of the first frame
+		if (mRecordingTime.isNull())
+		{
+			mRecordingTime.start();
+		}
+
+		mStream << quint8(InputRecording::Frame) << mFrameIndex << quint32(mRecordingTime.elapsed());
+		InputRecording::writeMouseState(mStream, aMouseState);
+
+		++mFrameIndex;
+	}
+}
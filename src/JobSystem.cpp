@@ -0,0 +1,348 @@
+/** This file is part of Cutexture.
+ 
+ Copyright (c) 2010 Markus Weiland, Kevin Lang
+
+ Portions of this code may be under copyright of authors listed in AUTHORS.
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+#include "JobSystem.h"
+#include "Exception.h"
+
+namespace Cutexture
+{
+	class JobSystem::Worker: public QThread
+	{
+	public:
+		Worker(JobSystem *aSystem, int aQueue) :
+			mSystem(aSystem), mQueue(aQueue)
+		{
+		}
+		
+	protected:
+		void run()
+		{
+			mSystem->work(mQueue);
+		}
+		
+	private:
+		JobSystem *mSystem;
+		int mQueue;
+	};
+	
+	JobSystem::JobSystem(int aWorkerCount) :
+		mQueuedTasks(0), mStealCount(0), mStopping(false), mMainThread(QThread::currentThread())
+	{
+		const int workerCount = qMax(0, aWorkerCount < 0 ? QThread::idealThreadCount() - 1
+				: aWorkerCount);
+		
+		// the main thread owns the last queue
+		for (int i = 0; i <= workerCount; ++i)
+		{
+			mQueues.append(new TaskQueue());
+		}
+		
+		for (int i = 0; i < workerCount; ++i)
+		{
+			mWorkers.append(new Worker(this, i));
+		}
+		
+		// workers steal from all queues, so start them once every queue exists
+		foreach(Worker *worker, mWorkers)
+		{
+			worker->start();
+		}
+	}
+	
+	JobSystem::~JobSystem()
+	{
+		QMutexLocker locker(&mSleepMutex);
+		mStopping = true;
+		mWorkAvailable.wakeAll();
+		locker.unlock();
+		
+		foreach(Worker *worker, mWorkers)
+		{
+			worker->wait();
+		}
+		
+		qDeleteAll(mWorkers);
+		qDeleteAll(mQueues);
+	}
+	
+	void JobSystem::run(JobGraph &aGraph)
+	{
+		assert(QThread::currentThread() == mMainThread);
+		
+		if (aGraph.mNodes.isEmpty())
+		{
+			return;
+		}
+		
+		aGraph.mPendingJobs = aGraph.mNodes.size();
+		aGraph.mFailed = 0;
+		aGraph.mError.clear();
+		
+		foreach(JobGraph::Node *node, aGraph.mNodes)
+		{
+			node->pendingDependencies = node->dependencyCount;
+		}
+		
+		const int mainQueue = getMainQueue();
+		
+		for (int i = 0; i < aGraph.mNodes.size(); ++i)
+		{
+			if (aGraph.mNodes.at(i)->dependencyCount == 0)
+			{
+				const Task task = { &aGraph, i };
+				pushTask(mainQueue, task);
+			}
+		}
+		
+		// the acquire makes the results of jobs finished on workers visible here
+		while (!aGraph.mPendingJobs.testAndSetAcquire(0, 0))
+		{
+			Task task;
+			bool found = false;
+			
+			QMutexLocker mainThreadLocker(&mMainThreadTasks.mutex);
+			if (!mMainThreadTasks.tasks.isEmpty())
+			{
+				task = mMainThreadTasks.tasks.takeFirst();
+				found = true;
+			}
+			mainThreadLocker.unlock();
+			
+			if (found || takeTask(mainQueue, task))
+			{
+				execute(mainQueue, task);
+				continue;
+			}
+			
+			QMutexLocker locker(&mSleepMutex);
+			mainThreadLocker.relock();
+			const bool idle = mMainThreadTasks.tasks.isEmpty() && mQueuedTasks == 0;
+			mainThreadLocker.unlock();
+			
+			if (idle && aGraph.mPendingJobs != 0)
+			{
+				mWorkAvailable.wait(&mSleepMutex);
+			}
+		}
+		
+		if (aGraph.mFailed != 0)
+		{
+			QMutexLocker locker(&aGraph.mErrorMutex);
+			EXCEPTION(aGraph.mError.toStdString(), "JobSystem::run()");
+		}
+	}
+	
+	int JobSystem::getStealCount() const
+	{
+		return mStealCount;
+	}
+	
+	void JobSystem::work(int aQueue)
+	{
+		Task task;
+		
+		forever
+		{
+			if (takeTask(aQueue, task))
+			{
+				execute(aQueue, task);
+				continue;
+			}
+			
+			QMutexLocker locker(&mSleepMutex);
+			if (mStopping)
+			{
+				return;
+			}
+			
+			// tasks are counted before their thread is woken, so none can be missed here
+			if (mQueuedTasks == 0)
+			{
+				mWorkAvailable.wait(&mSleepMutex);
+			}
+		}
+	}
+	
+	bool JobSystem::takeTask(int aQueue, Task &aTask)
+	{
+		// newest first, its data is most likely still in the cache
+		TaskQueue *ownQueue = mQueues.at(aQueue);
+		QMutexLocker ownLocker(&ownQueue->mutex);
+		if (!ownQueue->tasks.isEmpty())
+		{
+			aTask = ownQueue->tasks.takeLast();
+			mQueuedTasks.deref();
+			return true;
+		}
+		ownLocker.unlock();
+		
+		// oldest first, it is the root of the largest remaining part of the graph
+		for (int i = 1; i < mQueues.size(); ++i)
+		{
+			TaskQueue *victim = mQueues.at((aQueue + i) % mQueues.size());
+			QMutexLocker locker(&victim->mutex);
+			if (!victim->tasks.isEmpty())
+			{
+				aTask = victim->tasks.takeFirst();
+				mQueuedTasks.deref();
+				mStealCount.ref();
+				return true;
+			}
+		}
+		
+		return false;
+	}
+	
+	void JobSystem::pushTask(int aQueue, const Task &aTask)
+	{
+		if (aTask.graph->mNodes.at(aTask.job)->affinity == MainThread)
+		{
+			QMutexLocker mainThreadLocker(&mMainThreadTasks.mutex);
+			mMainThreadTasks.tasks.append(aTask);
+			mainThreadLocker.unlock();
+			
+			// the main thread waits together with the workers
+			QMutexLocker locker(&mSleepMutex);
+			mWorkAvailable.wakeAll();
+			return;
+		}
+		
+		TaskQueue *queue = mQueues.at(aQueue);
+		QMutexLocker queueLocker(&queue->mutex);
+		queue->tasks.append(aTask);
+		queueLocker.unlock();
+		
+		mQueuedTasks.ref();
+		
+		QMutexLocker locker(&mSleepMutex);
+		mWorkAvailable.wakeOne();
+	}
+	
+	void JobSystem::execute(int aQueue, const Task &aTask)
+	{
+		JobGraph &graph = *aTask.graph;
+		const JobGraph::Node *node = graph.mNodes.at(aTask.job);
+		
+		// after a failure, the remaining jobs are only retired so that run() returns
+		if (graph.mFailed == 0)
+		{
+			QString error;
+			
+			try
+			{
+				node->job->run();
+			}
+			catch (const Exception &e)
+			{
+				error = QString::fromStdString(e.getFullDescription());
+			}
+			catch (const std::exception &e)
+			{
+				error = e.what();
+			}
+			
+			if (!error.isEmpty())
+			{
+				QMutexLocker locker(&graph.mErrorMutex);
+				if (graph.mFailed == 0)
+				{
+					graph.mError = error;
+					graph.mFailed = 1;
+				}
+			}
+		}
+		
+		foreach(int successor, node->successors)
+		{
+			if (!graph.mNodes.at(successor)->pendingDependencies.deref())
+			{
+				const Task task = { &graph, successor };
+				pushTask(aQueue, task);
+			}
+		}
+		
+		// the graph may be gone once run() sees the last job finish
+		if (!graph.mPendingJobs.deref())
+		{
+			QMutexLocker locker(&mSleepMutex);
+			mWorkAvailable.wakeAll();
+		}
+	}
+	
+	JobGraph::JobGraph() :
+		mPendingJobs(0), mFailed(0)
+	{
+	}
+	
+	JobGraph::~JobGraph()
+	{
+		clear();
+	}
+	
+	int JobGraph::addJob(Job *aJob, const QList<int> &aDependencies, JobSystem::Affinity aAffinity)
+	{
+		assert(aJob);
+		
+		foreach(int dependency, aDependencies)
+		{
+			if (dependency < 0 || dependency >= mNodes.size())
+			{
+				delete aJob;
+				EXCEPTION("A job can only depend on jobs added before it.", "JobGraph::addJob()");
+			}
+		}
+		
+		const int id = mNodes.size();
+		
+		Node *node = new Node();
+		node->job = aJob;
+		node->affinity = aAffinity;
+		node->dependencyCount = 0;
+		
+		foreach(int dependency, aDependencies)
+		{
+			QVector<int> &successors = mNodes.at(dependency)->successors;
+			if (!successors.contains(id))
+			{
+				successors.append(id);
+				++node->dependencyCount;
+			}
+		}
+		
+		mNodes.append(node);
+		return id;
+	}
+	
+	void JobGraph::clear()
+	{
+		foreach(Node *node, mNodes)
+		{
+			delete node->job;
+			delete node;
+		}
+		
+		mNodes.clear();
+	}
+}
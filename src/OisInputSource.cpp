@@ -0,0 +1,157 @@
+/** This file is part of Cutexture.
+ 
+ Copyright (c) 2010 Markus Weiland, Kevin Lang
+
+ Portions of this code may be under copyright of authors listed in AUTHORS.
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+#include "OisInputSource.h"
+#include "Exception.h"
+
+namespace Cutexture
+{
+	OisInputSource::OisInputSource() :
+		mOis(NULL), mOisKeyboard(NULL), mOisMouse(NULL), mSystemCursorHidden(false)
+	{
+	}
+
+	OisInputSource::~OisInputSource()
+	{
+		if (mOis)
+		{
+			if (mOisKeyboard)
+			{
+				mOis->destroyInputObject(mOisKeyboard);
+				mOisKeyboard = 0;
+			}
+
+			if (mOisMouse)
+			{
+				mOis->destroyInputObject(mOisMouse);
+				mOisMouse = 0;
+			}
+
+			OIS::InputManager::destroyInputSystem(mOis);
+			mOis = 0;
+		}
+
+#if defined(OIS_WIN32_PLATFORM)
+		if (mSystemCursorHidden)
+		{
+			ShowCursor(TRUE);
+		}
+#endif
+	}
+
+	void OisInputSource::initialize(Ogre::RenderWindow *aRenderWindow, bool aHideSystemCursor)
+	{
+		// initialize only once
+		assert(!mOis);
+
+		// initialize the OpenInputSystem (OIS)
+		size_t windowHnd = 0;
+		aRenderWindow->getCustomAttribute("WINDOW", &windowHnd);
+		std::ostringstream windowHndStr;
+		windowHndStr << windowHnd;
+		OIS::ParamList paramList;
+		paramList.insert(std::make_pair(std::string("WINDOW"), windowHndStr.str()));
+#if defined(OIS_WIN32_PLATFORM)
+		// if activated, can break absolute mouse positioning
+		// TODO test if this works correctly with foreground and nonexclusive flags active
+		paramList.insert(std::make_pair(std::string("w32_mouse"), std::string("DISCL_FOREGROUND" )));
+		paramList.insert(std::make_pair(std::string("w32_mouse"), std::string("DISCL_NONEXCLUSIVE")));
+		//		paramList.insert(std::make_pair(std::string("w32_keyboard"), std::string("DISCL_FOREGROUND")));
+		//		paramList.insert(std::make_pair(std::string("w32_keyboard"), std::string("DISCL_NONEXCLUSIVE")));
+
+		// a non-exclusive DirectInput mouse keeps the system cursor visible
+		if (aHideSystemCursor)
+		{
+			ShowCursor(FALSE);
+		}
+#elif defined(OIS_LINUX_PLATFORM)
+		paramList.insert(std::make_pair(std::string("x11_mouse_grab"), std::string("false")));
+		paramList.insert(std::make_pair(std::string("x11_mouse_hide"), std::string(aHideSystemCursor ? "true" : "false")));
+		paramList.insert(std::make_pair(std::string("x11_keyboard_grab"), std::string("false")));
+		paramList.insert(std::make_pair(std::string("XAutoRepeatOn"), std::string("true")));
+#endif
+		mOis = OIS::InputManager::createInputSystem(paramList);
+		mSystemCursorHidden = aHideSystemCursor;
+
+		try
+		{
+			mOisKeyboard = static_cast<OIS::Keyboard*> (mOis->createInputObject(OIS::OISKeyboard,
+					true));
+			mOisKeyboard->setTextTranslation(OIS::Keyboard::Unicode);
+		}
+		catch (...)
+		{
+			EXCEPTION("Could not initialize keyboard", "OisInputSource::initialize()");
+		}
+
+		try
+		{
+			mOisMouse = static_cast<OIS::Mouse*> (mOis->createInputObject(OIS::OISMouse, true));
+
+
+			//Set mouse clipping area
+			unsigned int width, height, depth;
+			int left, top;
+
+			aRenderWindow->getMetrics(width, height, depth, left, top);
+			setMouseArea(width, height);
+		}
+		catch (...)
+		{
+			EXCEPTION("Could not initialize mouse", "OisInputSource::initialize()");
+		}
+	}
+
+	void OisInputSource::setEventCallbacks(OIS::MouseListener *aMouseListener,
+			OIS::KeyListener *aKeyListener)
+	{
+		assert(mOisKeyboard && mOisMouse);
+
+		mOisKeyboard->setEventCallback(aKeyListener);
+		mOisMouse->setEventCallback(aMouseListener);
+	}
+
+	void OisInputSource::capture()
+	{
+		assert(mOis && mOisKeyboard && mOisMouse);
+
+		mOisKeyboard->capture();
+		mOisMouse->capture();
+	}
+
+	const OIS::MouseState &OisInputSource::getMouseState() const
+	{
+		assert(mOisMouse);
+
+		return mOisMouse->getMouseState();
+	}
+
+	void OisInputSource::setMouseArea(int aWidth, int aHeight)
+	{
+		const OIS::MouseState &mouseState = mOisMouse->getMouseState();
+		mouseState.width = aWidth;
+		mouseState.height = aHeight;
+	}
+}
@@ -0,0 +1,202 @@
+/** This file is part of Cutexture.
+ 
+ Copyright (c) 2010 Markus Weiland, Kevin Lang
+
+ Portions of this code may be under copyright of authors listed in AUTHORS.
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+#include "PackArchive.h"
+#include "Constants.h"
+#include "Exception.h"
+
+namespace Cutexture
+{
+	PackArchive::PackArchive(const Ogre::String &aName, const Ogre::String &aArchiveType) :
+		Ogre::Archive(aName, aArchiveType)
+	{
+	}
+	
+	PackArchive::~PackArchive()
+	{
+		unload();
+	}
+	
+	bool PackArchive::isCaseSensitive() const
+	{
+		return true;
+	}
+	
+	void PackArchive::load()
+	{
+		if (mPack.isOpen())
+		{
+			return;
+		}
+		
+		if (!mPack.open(QString::fromStdString(mName)))
+		{
+			EXCEPTION("Cannot open resource pack '" + mName + "'.",
+					"PackArchive::load()");
+		}
+	}
+	
+	void PackArchive::unload()
+	{
+		mPack.close();
+	}
+	
+	Ogre::DataStreamPtr PackArchive::open(const Ogre::String &aFileName, bool aReadOnly) const
+	{
+		const QString entry = QString::fromStdString(aFileName);
+		if (!mPack.contains(entry))
+		{
+			return Ogre::DataStreamPtr();
+		}
+		
+		// uncompressed entries are streamed straight from the mapped file
+		const uchar *data = mPack.map(entry);
+		if (data)
+		{
+			return Ogre::DataStreamPtr(OGRE_NEW Ogre::MemoryDataStream(aFileName,
+					const_cast<uchar *> (data), size_t(mPack.getSize(entry)), false, true));
+		}
+		
+		const QByteArray contents = mPack.read(entry);
+		Ogre::MemoryDataStream *stream = OGRE_NEW Ogre::MemoryDataStream(aFileName, contents.size(),
+				true, true);
+		memcpy(stream->getPtr(), contents.constData(), contents.size());
+		
+		return Ogre::DataStreamPtr(stream);
+	}
+	
+	Ogre::StringVectorPtr PackArchive::list(bool aRecursive, bool aDirs)
+	{
+		return find("*", aRecursive, aDirs);
+	}
+	
+	Ogre::FileInfoListPtr PackArchive::listFileInfo(bool aRecursive, bool aDirs)
+	{
+		return findFileInfo("*", aRecursive, aDirs);
+	}
+	
+	Ogre::StringVectorPtr PackArchive::find(const Ogre::String &aPattern, bool aRecursive, bool aDirs)
+	{
+		Ogre::StringVectorPtr result(OGRE_NEW_T(Ogre::StringVector, Ogre::MEMCATEGORY_GENERAL)(),
+				Ogre::SPFM_DELETE_T);
+		
+		// packs only contain files
+		if (aDirs)
+		{
+			return result;
+		}
+		
+		foreach(const QString &entry, findEntries(aPattern, aRecursive))
+		{
+			result->push_back(entry.toStdString());
+		}
+		
+		return result;
+	}
+	
+	Ogre::FileInfoListPtr PackArchive::findFileInfo(const Ogre::String &aPattern, bool aRecursive,
+			bool aDirs) const
+	{
+		Ogre::FileInfoListPtr result(OGRE_NEW_T(Ogre::FileInfoList, Ogre::MEMCATEGORY_GENERAL)(),
+				Ogre::SPFM_DELETE_T);
+		
+		if (aDirs)
+		{
+			return result;
+		}
+		
+		foreach(const QString &entry, findEntries(aPattern, aRecursive))
+		{
+			result->push_back(getFileInfo(entry));
+		}
+		
+		return result;
+	}
+	
+	bool PackArchive::exists(const Ogre::String &aFileName)
+	{
+		return mPack.contains(QString::fromStdString(aFileName));
+	}
+	
+	time_t PackArchive::getModifiedTime(const Ogre::String &aFileName)
+	{
+		return QFileInfo(mPack.getFileName()).lastModified().toTime_t();
+	}
+	
+	QStringList PackArchive::findEntries(const Ogre::String &aPattern, bool aRecursive) const
+	{
+		const bool fullPath = (aPattern.find('/') != Ogre::String::npos);
+		QStringList entries;
+		
+		foreach(const QString &entry, mPack.getEntryNames())
+		{
+			const bool nested = entry.contains('/');
+			if (nested && !aRecursive && !fullPath)
+			{
+				continue;
+			}
+			
+			const QString matched = fullPath ? entry : entry.section('/', -1);
+			if (Ogre::StringUtil::match(matched.toStdString(), aPattern, true))
+			{
+				entries.append(entry);
+			}
+		}
+		
+		return entries;
+	}
+	
+	Ogre::FileInfo PackArchive::getFileInfo(const QString &aEntry) const
+	{
+		Ogre::FileInfo info;
+		info.archive = this;
+		info.filename = aEntry.toStdString();
+		info.path = aEntry.contains('/') ? aEntry.section('/', 0, -2).toStdString() + "/" : "";
+		info.basename = aEntry.section('/', -1).toStdString();
+		info.uncompressedSize = size_t(mPack.getSize(aEntry));
+		info.compressedSize = size_t(mPack.getStoredSize(aEntry));
+		
+		return info;
+	}
+	
+	PackArchiveFactory::~PackArchiveFactory()
+	{
+	}
+	
+	const Ogre::String& PackArchiveFactory::getType() const
+	{
+		return Constants::RESOURCE_PACK_ARCHIVE_TYPE;
+	}
+	
+	Ogre::Archive* PackArchiveFactory::createInstance(const Ogre::String &aName)
+	{
+		return OGRE_NEW PackArchive(aName, getType());
+	}
+	
+	void PackArchiveFactory::destroyInstance(Ogre::Archive *aArchive)
+	{
+		OGRE_DELETE aArchive;
+	}
+}
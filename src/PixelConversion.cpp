@@ -0,0 +1,204 @@
+/** This file is part of Cutexture.
+ 
+ Copyright (c) 2010 Markus Weiland, Kevin Lang
+
+ Portions of this code may be under copyright of authors listed in AUTHORS.
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+#include "PixelConversion.h"
+
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CUTEXTURE_HAVE_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+	/* Each converter converts a row of ARGB32 pixels to one format. 
+	 * BLOCK_SIZE pixels at a time are converted by convertBlock(), 
+	 * the rest by convertPixel(). */
+	
+	struct ConvertARGB4444
+	{
+		typedef quint16 Target;
+		static const int BLOCK_SIZE = 8;
+		
+		static inline Target convertPixel(quint32 aPixel)
+		{
+			return Target(((aPixel >> 16) & 0xf000) | ((aPixel >> 12) & 0x0f00) | ((aPixel
+					>> 8) & 0x00f0) | ((aPixel >> 4) & 0x000f));
+		}
+		
+#ifdef CUTEXTURE_HAVE_SSE2
+		static inline __m128i convertQuad(__m128i aPixels)
+		{
+			__m128i result = _mm_and_si128(_mm_srli_epi32(aPixels, 16), _mm_set1_epi32(0xf000));
+			result = _mm_or_si128(result, _mm_and_si128(_mm_srli_epi32(aPixels, 12), _mm_set1_epi32(0x0f00)));
+			result = _mm_or_si128(result, _mm_and_si128(_mm_srli_epi32(aPixels, 8), _mm_set1_epi32(0x00f0)));
+			result = _mm_or_si128(result, _mm_and_si128(_mm_srli_epi32(aPixels, 4), _mm_set1_epi32(0x000f)));
+			
+			// sign extend so that the signed saturation of packs keeps all 16 bits
+			return _mm_srai_epi32(_mm_slli_epi32(result, 16), 16);
+		}
+		
+		static inline void convertBlock(const quint32 *aSource, Target *aTarget)
+		{
+			const __m128i low = convertQuad(_mm_loadu_si128(reinterpret_cast<const __m128i *> (aSource)));
+			const __m128i high = convertQuad(_mm_loadu_si128(reinterpret_cast<const __m128i *> (aSource + 4)));
+			_mm_storeu_si128(reinterpret_cast<__m128i *> (aTarget), _mm_packs_epi32(low, high));
+		}
+#endif
+	};
+	
+	struct ConvertARGB1555
+	{
+		typedef quint16 Target;
+		static const int BLOCK_SIZE = 8;
+		
+		static inline Target convertPixel(quint32 aPixel)
+		{
+			return Target(((aPixel >> 16) & 0x8000) | ((aPixel >> 9) & 0x7c00) | ((aPixel >> 6)
+					& 0x03e0) | ((aPixel >> 3) & 0x001f));
+		}
+		
+#ifdef CUTEXTURE_HAVE_SSE2
+		static inline __m128i convertQuad(__m128i aPixels)
+		{
+			__m128i result = _mm_and_si128(_mm_srli_epi32(aPixels, 16), _mm_set1_epi32(0x8000));
+			result = _mm_or_si128(result, _mm_and_si128(_mm_srli_epi32(aPixels, 9), _mm_set1_epi32(0x7c00)));
+			result = _mm_or_si128(result, _mm_and_si128(_mm_srli_epi32(aPixels, 6), _mm_set1_epi32(0x03e0)));
+			result = _mm_or_si128(result, _mm_and_si128(_mm_srli_epi32(aPixels, 3), _mm_set1_epi32(0x001f)));
+			
+			return _mm_srai_epi32(_mm_slli_epi32(result, 16), 16);
+		}
+		
+		static inline void convertBlock(const quint32 *aSource, Target *aTarget)
+		{
+			const __m128i low = convertQuad(_mm_loadu_si128(reinterpret_cast<const __m128i *> (aSource)));
+			const __m128i high = convertQuad(_mm_loadu_si128(reinterpret_cast<const __m128i *> (aSource + 4)));
+			_mm_storeu_si128(reinterpret_cast<__m128i *> (aTarget), _mm_packs_epi32(low, high));
+		}
+#endif
+	};
+	
+	struct ConvertAlpha8
+	{
+		typedef quint8 Target;
+		static const int BLOCK_SIZE = 16;
+		
+		static inline Target convertPixel(quint32 aPixel)
+		{
+			return Target(aPixel >> 24);
+		}
+		
+#ifdef CUTEXTURE_HAVE_SSE2
+		static inline void convertBlock(const quint32 *aSource, Target *aTarget)
+		{
+			const __m128i *source = reinterpret_cast<const __m128i *> (aSource);
+			const __m128i a0 = _mm_srli_epi32(_mm_loadu_si128(source), 24);
+			const __m128i a1 = _mm_srli_epi32(_mm_loadu_si128(source + 1), 24);
+			const __m128i a2 = _mm_srli_epi32(_mm_loadu_si128(source + 2), 24);
+			const __m128i a3 = _mm_srli_epi32(_mm_loadu_si128(source + 3), 24);
+			
+			const __m128i low = _mm_packs_epi32(a0, a1);
+			const __m128i high = _mm_packs_epi32(a2, a3);
+			_mm_storeu_si128(reinterpret_cast<__m128i *> (aTarget), _mm_packus_epi16(low, high));
+		}
+#endif
+	};
+	
+	template<class Converter>
+	void convertRows(const QImage &aSource, const QRect &aRect, uchar *aTarget, int aTargetBytesPerLine)
+	{
+		typedef typename Converter::Target Target;
+		
+		for (int y = 0; y < aRect.height(); ++y)
+		{
+			const quint32 *source = reinterpret_cast<const quint32 *> (aSource.constScanLine(aRect.top() + y)) + aRect.left();
+			Target *target = reinterpret_cast<Target *> (aTarget + y * aTargetBytesPerLine);
+			int x = 0;
+			
+#ifdef CUTEXTURE_HAVE_SSE2
+			for (; x + Converter::BLOCK_SIZE <= aRect.width(); x += Converter::BLOCK_SIZE)
+			{
+				Converter::convertBlock(source + x, target + x);
+			}
+#endif
+			
+			for (; x < aRect.width(); ++x)
+			{
+				target[x] = Converter::convertPixel(source[x]);
+			}
+		}
+	}
+}
+
+namespace Cutexture
+{
+	namespace Utility
+	{
+		Ogre::PixelFormat toOgrePixelFormat(Enums::TextureFormat aFormat)
+		{
+			switch (aFormat)
+			{
+			case Enums::TextureFormatARGB4444:
+				return Ogre::PF_A4R4G4B4;
+			case Enums::TextureFormatARGB1555:
+				return Ogre::PF_A1R5G5B5;
+			case Enums::TextureFormatAlpha8:
+				return Ogre::PF_A8;
+			case Enums::TextureFormatARGB8888:
+			default:
+				return Ogre::PF_A8R8G8B8;
+			}
+		}
+		
+		void convertPixels(const QImage &aSource, const QRect &aRect, Enums::TextureFormat aFormat,
+				uchar *aTarget, int aTargetBytesPerLine)
+		{
+			assert(aSource.format() == QImage::Format_ARGB32);
+			assert(aSource.rect().contains(aRect));
+			
+			switch (aFormat)
+			{
+			case Enums::TextureFormatARGB4444:
+				convertRows<ConvertARGB4444> (aSource, aRect, aTarget, aTargetBytesPerLine);
+				break;
+			case Enums::TextureFormatARGB1555:
+				convertRows<ConvertARGB1555> (aSource, aRect, aTarget, aTargetBytesPerLine);
+				break;
+			case Enums::TextureFormatAlpha8:
+				convertRows<ConvertAlpha8> (aSource, aRect, aTarget, aTargetBytesPerLine);
+				break;
+			case Enums::TextureFormatARGB8888:
+			default:
+				for (int y = 0; y < aRect.height(); ++y)
+				{
+					std::memcpy(aTarget + y * aTargetBytesPerLine, aSource.constScanLine(aRect.top()
+							+ y) + aRect.left() * 4, aRect.width() * 4);
+				}
+				break;
+			}
+		}
+	}
+}
@@ -0,0 +1,290 @@
+/** This file is part of Cutexture.
+ 
+ Copyright (c) 2010 Markus Weiland, Kevin Lang
+
+ Portions of this code may be under copyright of authors listed in AUTHORS.
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+#include "RemoteUiClient.h"
+#include "RemoteUiProtocol.h"
+#include "PixelConversion.h"
+#include "Constants.h"
+
+namespace Cutexture
+{
+	RemoteUiClient::RemoteUiClient(QObject *aParent) :
+		QObject(aParent), mServer(NULL), mSocket(NULL), mProcess(NULL), mSharedMemory(NULL),
+				mGeneration(0), mPendingSlot(-1), mCursorShape(Qt::ArrowCursor)
+	{
+	}
+	
+	RemoteUiClient::~RemoteUiClient()
+	{
+		stop();
+	}
+	
+	bool RemoteUiClient::start(const QString &aProgram, const QStringList &aArguments)
+	{
+		stop();
+		
+		mServer = new QLocalServer(this);
+		mServerName = QString("cutexture-ui-%1-%2").arg(QCoreApplication::applicationPid()).arg(
+				quintptr(this), 0, 16);
+		if (!mServer->listen(mServerName))
+		{
+			stop();
+			return false;
+		}
+		
+		mProcess = new QProcess(this);
+		mProcess->setProcessChannelMode(QProcess::ForwardedChannels);
+		mProcess->start(aProgram, QStringList() << mServerName << aArguments);
+		
+		if (!mServer->waitForNewConnection(Constants::REMOTE_UI_CONNECT_TIMEOUT))
+		{
+			stop();
+			return false;
+		}
+		
+		mSocket = mServer->nextPendingConnection();
+		connect(mSocket, SIGNAL(readyRead()), this, SLOT(readMessages()));
+		connect(mSocket, SIGNAL(disconnected()), this, SLOT(socketDisconnected()));
+		
+		// only one helper per client
+		mSocket->setParent(this);
+		delete mServer;
+		mServer = NULL;
+		
+		if (mSize.isValid())
+		{
+			resize(mSize);
+		}
+		
+		return true;
+	}
+	
+	void RemoteUiClient::stop()
+	{
+		if (mSocket)
+		{
+			mSocket->disconnect(this);
+			mSocket->abort();
+			mSocket->deleteLater();
+			mSocket = NULL;
+		}
+		
+		if (mProcess)
+		{
+			// the helper quits when the connection is closed
+			if (!mProcess->waitForFinished(Constants::REMOTE_UI_CONNECT_TIMEOUT))
+			{
+				mProcess->kill();
+				mProcess->waitForFinished();
+			}
+			delete mProcess;
+			mProcess = NULL;
+		}
+		
+		delete mServer;
+		mServer = NULL;
+		
+		delete mSharedMemory;
+		mSharedMemory = NULL;
+		
+		mPendingSlot = -1;
+		mPendingRects.clear();
+		mContentBounds = QRect();
+	}
+	
+	bool RemoteUiClient::isConnected() const
+	{
+		return (mSocket && mSocket->state() == QLocalSocket::ConnectedState);
+	}
+	
+	void RemoteUiClient::resize(const QSize &aSize)
+	{
+		mSize = aSize;
+		
+		if (!isConnected() || aSize.isEmpty())
+		{
+			return;
+		}
+		
+		++mGeneration;
+		mPendingSlot = -1;
+		mPendingRects.clear();
+		
+		delete mSharedMemory;
+		mSharedMemory = new QSharedMemory(mServerName + QString("-%1").arg(mGeneration), this);
+		
+		if (!mSharedMemory->create(RemoteUi::getSharedMemorySize(aSize)))
+		{
+			Ogre::LogManager::getSingleton().logMessage("Cannot create shared memory for the remote UI: "
+					+ mSharedMemory->errorString().toStdString());
+			delete mSharedMemory;
+			mSharedMemory = NULL;
+			return;
+		}
+		
+		QByteArray message;
+		QDataStream stream(&message, QIODevice::WriteOnly);
+		stream << quint8(RemoteUi::MessageResize) << aSize << mSharedMemory->key() << mGeneration;
+		send(message);
+	}
+	
+	void RemoteUiClient::sendMouseEvent(const QMouseEvent *aEvent)
+	{
+		QByteArray message;
+		QDataStream stream(&message, QIODevice::WriteOnly);
+		stream << quint8(RemoteUi::MessageMouseEvent) << quint8(aEvent->type()) << aEvent->pos()
+				<< quint32(aEvent->button()) << quint32(aEvent->buttons())
+				<< quint32(aEvent->modifiers());
+		send(message);
+	}
+	
+	void RemoteUiClient::sendKeyEvent(const QKeyEvent *aEvent)
+	{
+		QByteArray message;
+		QDataStream stream(&message, QIODevice::WriteOnly);
+		stream << quint8(RemoteUi::MessageKeyEvent) << quint8(aEvent->type()) << qint32(aEvent->key())
+				<< quint32(aEvent->modifiers()) << aEvent->text();
+		send(message);
+	}
+	
+	int RemoteUiClient::uploadFrame(const Ogre::TexturePtr &aTexture, Enums::TextureFormat aFormat)
+	{
+		assert(!aTexture.isNull());
+		
+		if (mPendingSlot < 0 || !mSharedMemory)
+		{
+			return 0;
+		}
+		
+		const QImage frame = RemoteUi::getSlotImage(mSharedMemory->data(), mSize, mPendingSlot);
+		const QRect textureRect = QRect(0, 0, aTexture->getWidth(), aTexture->getHeight())
+				& frame.rect();
+		int uploadedPixels = 0;
+		
+		Ogre::HardwarePixelBufferSharedPtr hwBuffer = aTexture->getBuffer(0, 0);
+		hwBuffer->lock(Ogre::HardwareBuffer::HBL_NORMAL);
+		
+		const Ogre::PixelBox &pb = hwBuffer->getCurrentLock();
+		const int bytesPerPixel = Ogre::PixelUtil::getNumElemBytes(pb.format);
+		const int bytesPerLine = pb.rowPitch * bytesPerPixel;
+		
+		foreach(const QRect &changedRect, mPendingRects)
+		{
+			const QRect rect = changedRect & textureRect;
+			if (rect.isEmpty())
+			{
+				continue;
+			}
+			
+			Utility::convertPixels(frame, rect, aFormat, static_cast<uchar *> (pb.data) + rect.top()
+					* bytesPerLine + rect.left() * bytesPerPixel, bytesPerLine);
+			uploadedPixels += rect.width() * rect.height();
+		}
+		
+		hwBuffer->unlock();
+		
+		releaseSlot(mGeneration, mPendingSlot);
+		mPendingSlot = -1;
+		mPendingRects.clear();
+		
+		return uploadedPixels;
+	}
+	
+	void RemoteUiClient::readMessages()
+	{
+		QByteArray message;
+		while (mSocket && RemoteUi::readMessage(mSocket, message))
+		{
+			QDataStream stream(message);
+			quint8 type;
+			stream >> type;
+			
+			switch (type)
+			{
+				case RemoteUi::MessageFrameReady:
+				{
+					quint32 generation;
+					quint8 slot;
+					QVector<QRect> changedRects;
+					QRect contentBounds;
+					stream >> generation >> slot >> changedRects >> contentBounds;
+					
+					if (generation != mGeneration || slot >= Constants::REMOTE_UI_FRAME_SLOTS)
+					{
+						releaseSlot(generation, slot);
+						break;
+					}
+					
+					// every frame is complete, so the newest one also holds the changes of a skipped one
+					if (mPendingSlot >= 0)
+					{
+						releaseSlot(mGeneration, mPendingSlot);
+					}
+					
+					mPendingSlot = slot;
+					mPendingRects += changedRects;
+					mContentBounds = contentBounds;
+					emit(frameReady());
+					break;
+				}
+				case RemoteUi::MessageCursorChanged:
+				{
+					qint32 shape;
+					stream >> shape;
+					mCursorShape = Qt::CursorShape(shape);
+					break;
+				}
+				default:
+					break;
+			}
+		}
+	}
+	
+	void RemoteUiClient::socketDisconnected()
+	{
+		mPendingSlot = -1;
+		mPendingRects.clear();
+		mContentBounds = QRect();
+		
+		emit(disconnected());
+	}
+	
+	void RemoteUiClient::send(const QByteArray &aMessage)
+	{
+		if (isConnected())
+		{
+			RemoteUi::writeMessage(mSocket, aMessage);
+			mSocket->flush();
+		}
+	}
+	
+	void RemoteUiClient::releaseSlot(quint32 aGeneration, int aSlot)
+	{
+		QByteArray message;
+		QDataStream stream(&message, QIODevice::WriteOnly);
+		stream << quint8(RemoteUi::MessageFrameReleased) << aGeneration << quint8(aSlot);
+		send(message);
+	}
+}
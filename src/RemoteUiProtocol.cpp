@@ -0,0 +1,75 @@
+/** This file is part of Cutexture.
+ 
+ Copyright (c) 2010 Markus Weiland, Kevin Lang
+
+ Portions of this code may be under copyright of authors listed in AUTHORS.
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+#include "RemoteUiProtocol.h"
+#include "Constants.h"
+
+namespace Cutexture
+{
+	namespace RemoteUi
+	{
+		int getSharedMemorySize(const QSize &aSize)
+		{
+			return aSize.width() * aSize.height() * 4 * Constants::REMOTE_UI_FRAME_SLOTS;
+		}
+		
+		QImage getSlotImage(void *aData, const QSize &aSize, int aSlot)
+		{
+			assert(aSlot >= 0 && aSlot < Constants::REMOTE_UI_FRAME_SLOTS);
+			
+			const int slotBytes = aSize.width() * aSize.height() * 4;
+			return QImage(static_cast<uchar *> (aData) + aSlot * slotBytes, aSize.width(),
+					aSize.height(), aSize.width() * 4, QImage::Format_ARGB32);
+		}
+		
+		void writeMessage(QIODevice *aDevice, const QByteArray &aMessage)
+		{
+			const quint32 length = qToBigEndian<quint32> (aMessage.size());
+			aDevice->write(reinterpret_cast<const char *> (&length), sizeof(length));
+			aDevice->write(aMessage);
+		}
+		
+		bool readMessage(QIODevice *aDevice, QByteArray &aMessage)
+		{
+			quint32 length = 0;
+			if (aDevice->bytesAvailable() < qint64(sizeof(length)))
+			{
+				return false;
+			}
+			
+			aDevice->peek(reinterpret_cast<char *> (&length), sizeof(length));
+			length = qFromBigEndian<quint32> (length);
+			
+			if (aDevice->bytesAvailable() < qint64(sizeof(length) + length))
+			{
+				return false;
+			}
+			
+			aDevice->read(sizeof(length));
+			aMessage = aDevice->read(length);
+			return true;
+		}
+	}
+}
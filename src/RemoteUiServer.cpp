@@ -0,0 +1,238 @@
+/** This file is part of Cutexture.
+ 
+ Copyright (c) 2010 Markus Weiland, Kevin Lang
+
+ Portions of this code may be under copyright of authors listed in AUTHORS.
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+#include "RemoteUiServer.h"
+#include "RemoteUiProtocol.h"
+#include "UiManager.h"
+#include "Constants.h"
+
+namespace Cutexture
+{
+	RemoteUiServer::RemoteUiServer(UiManager *aUiManager, QObject *aParent) :
+		QObject(aParent), mUiManager(aUiManager), mSocket(NULL), mSharedMemory(NULL),
+				mGeneration(0), mTileDiff(Constants::UI_TILE_SIZE), mRenderTimer(NULL),
+				mCursorShape(Qt::ArrowCursor)
+	{
+		assert(aUiManager);
+		
+		for (int i = 0; i < Constants::REMOTE_UI_FRAME_SLOTS; ++i)
+		{
+			mSlotBusy[i] = false;
+		}
+		
+		mRenderTimer = new QTimer(this);
+		mRenderTimer->setInterval(Constants::REMOTE_UI_RENDER_INTERVAL);
+		connect(mRenderTimer, SIGNAL(timeout()), this, SLOT(renderFrame()));
+	}
+	
+	RemoteUiServer::~RemoteUiServer()
+	{
+		delete mSharedMemory;
+	}
+	
+	bool RemoteUiServer::connectToHost(const QString &aServerName)
+	{
+		assert(!mSocket);
+		
+		mSocket = new QLocalSocket(this);
+		mSocket->connectToServer(aServerName);
+		
+		if (!mSocket->waitForConnected(Constants::REMOTE_UI_CONNECT_TIMEOUT))
+		{
+			return false;
+		}
+		
+		connect(mSocket, SIGNAL(readyRead()), this, SLOT(readMessages()));
+		connect(mSocket, SIGNAL(disconnected()), QCoreApplication::instance(), SLOT(quit()));
+		
+		mRenderTimer->start();
+		return true;
+	}
+	
+	void RemoteUiServer::readMessages()
+	{
+		QByteArray message;
+		while (RemoteUi::readMessage(mSocket, message))
+		{
+			QDataStream stream(message);
+			quint8 type;
+			stream >> type;
+			
+			switch (type)
+			{
+				case RemoteUi::MessageResize:
+				{
+					QSize size;
+					QString key;
+					quint32 generation;
+					stream >> size >> key >> generation;
+					resize(size, key, generation);
+					break;
+				}
+				case RemoteUi::MessageMouseEvent:
+				{
+					quint8 eventType;
+					QPoint pos;
+					quint32 button, buttons, modifiers;
+					stream >> eventType >> pos >> button >> buttons >> modifiers;
+					
+					QMouseEvent event(QEvent::Type(eventType), pos, pos, Qt::MouseButton(button),
+							Qt::MouseButtons(buttons), Qt::KeyboardModifiers(modifiers));
+					if (event.type() == QEvent::MouseButtonPress)
+					{
+						mUiManager->mousePressEvent(&event);
+					}
+					else if (event.type() == QEvent::MouseButtonRelease)
+					{
+						mUiManager->mouseReleaseEvent(&event);
+					}
+					else
+					{
+						mUiManager->mouseMoveEvent(&event);
+					}
+					break;
+				}
+				case RemoteUi::MessageKeyEvent:
+				{
+					quint8 eventType;
+					qint32 key;
+					quint32 modifiers;
+					QString text;
+					stream >> eventType >> key >> modifiers >> text;
+					
+					QKeyEvent event(QEvent::Type(eventType), key, Qt::KeyboardModifiers(modifiers), text);
+					if (event.type() == QEvent::KeyPress)
+					{
+						mUiManager->keyPressEvent(&event);
+					}
+					else
+					{
+						mUiManager->keyReleaseEvent(&event);
+					}
+					break;
+				}
+				case RemoteUi::MessageFrameReleased:
+				{
+					quint32 generation;
+					quint8 slot;
+					stream >> generation >> slot;
+					
+					if (generation == mGeneration && slot < Constants::REMOTE_UI_FRAME_SLOTS)
+					{
+						mSlotBusy[slot] = false;
+					}
+					break;
+				}
+				default:
+					break;
+			}
+		}
+	}
+	
+	void RemoteUiServer::renderFrame()
+	{
+		const Qt::CursorShape cursorShape = mUiManager->getCursor().shape();
+		if (cursorShape != mCursorShape)
+		{
+			mCursorShape = cursorShape;
+			
+			QByteArray message;
+			QDataStream stream(&message, QIODevice::WriteOnly);
+			stream << quint8(RemoteUi::MessageCursorChanged) << qint32(cursorShape);
+			send(message);
+		}
+		
+		if (!mSharedMemory || !mUiManager->isUiDirty())
+		{
+			return;
+		}
+		
+		int slot = 0;
+		while (slot < Constants::REMOTE_UI_FRAME_SLOTS && mSlotBusy[slot])
+		{
+			++slot;
+		}
+		
+		// the game has not uploaded the previous frames yet; try again later
+		if (slot == Constants::REMOTE_UI_FRAME_SLOTS)
+		{
+			return;
+		}
+		
+		mUiManager->setUiDirty(false);
+		
+		QImage frame = RemoteUi::getSlotImage(mSharedMemory->data(), mSize, slot);
+		mUiManager->renderIntoImage(frame);
+		
+		const QVector<QRect> changedRects = mTileDiff.update(frame);
+		if (changedRects.isEmpty())
+		{
+			return;
+		}
+		
+		mSlotBusy[slot] = true;
+		
+		QByteArray message;
+		QDataStream stream(&message, QIODevice::WriteOnly);
+		stream << quint8(RemoteUi::MessageFrameReady) << mGeneration << quint8(slot)
+				<< changedRects << mUiManager->getContentBounds();
+		send(message);
+	}
+	
+	void RemoteUiServer::resize(const QSize &aSize, const QString &aKey, quint32 aGeneration)
+	{
+		delete mSharedMemory;
+		mSharedMemory = new QSharedMemory(aKey, this);
+		
+		if (!mSharedMemory->attach())
+		{
+			qWarning() << "Cannot attach to the shared memory of the game:" << mSharedMemory->errorString();
+			delete mSharedMemory;
+			mSharedMemory = NULL;
+			return;
+		}
+		
+		mSize = aSize;
+		mGeneration = aGeneration;
+		
+		// slots of older generations are gone with their shared memory
+		for (int i = 0; i < Constants::REMOTE_UI_FRAME_SLOTS; ++i)
+		{
+			mSlotBusy[i] = false;
+		}
+		mTileDiff.reset();
+		
+		QResizeEvent resizeEvent(aSize, QSize());
+		mUiManager->resizeUi(&resizeEvent);
+		mUiManager->setViewSize(aSize);
+		mUiManager->setUiDirty(true);
+	}
+	
+	void RemoteUiServer::send(const QByteArray &aMessage)
+	{
+		RemoteUi::writeMessage(mSocket, aMessage);
+		mSocket->flush();
+	}
+}
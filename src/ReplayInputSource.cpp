@@ -0,0 +1,251 @@
+/** This file is part of Cutexture.
+ 
+ Copyright (c) 2010 Markus Weiland, Kevin Lang
+
+ Portions of this code may be under copyright of authors listed in AUTHORS.
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+#include "ReplayInputSource.h"
+#include "Exception.h"
+
+namespace Cutexture
+{
+	ReplayInputSource::ReplayInputSource(const QString &aFileName, bool aRealTime) :
+		mFile(aFileName), mRealTime(aRealTime), mMouseListener(NULL), mKeyListener(NULL),
+				mLastFrameTimestamp(0), mLastFrameDuration(0), mFrameCount(0),
+				mNextFrameTimestamp(0), mNextFrameTimestampValid(false)
+	{
+		if (!mFile.open(QFile::ReadOnly))
+		{
+			EXCEPTION("Could not open input recording file " + aFileName.toStdString() + ".",
+					"ReplayInputSource::ReplayInputSource()");
+		}
+
+		mStream.setDevice(&mFile);
+
+		quint32 magic = 0;
+		quint16 version = 0;
+		mStream >> magic >> version;
+
+		if (magic != InputRecording::MAGIC || version != InputRecording::VERSION)
+		{
+			EXCEPTION(aFileName.toStdString() + " is not a supported input recording.",
+					"ReplayInputSource::ReplayInputSource()");
+		}
+
+		mMouseState.clear();
+	}
+
+	ReplayInputSource::~ReplayInputSource()
+	{
+		mStream.setDevice(NULL);
+		mFile.close();
+	}
+
+	void ReplayInputSource::setEventCallbacks(OIS::MouseListener *aMouseListener,
+			OIS::KeyListener *aKeyListener)
+	{
+		mMouseListener = aMouseListener;
+		mKeyListener = aKeyListener;
+	}
+
+	void ReplayInputSource::capture()
+	{
+		// relative movement of all frames delivered by this capture
+		OIS::MouseState relative;
+		relative.clear();
+
+		if (!mRealTime)
+		{
+			if (!isFinished())
+			{
+				replayFrame(relative);
+			}
+		}
+		else
+		{
+			// the replay clock starts with the first capture, like the recording clock
+			if (mReplayTime.isNull())
+			{
+				mReplayTime.start();
+			}
+
+			while (!isFinished())
+			{
+				if (!mNextFrameTimestampValid)
+				{
+					if (!peekNextFrameTimestamp(mNextFrameTimestamp))
+					{
+						break;
+					}
+					mNextFrameTimestampValid = true;
+				}
+
+				if (mNextFrameTimestamp > quint32(mReplayTime.elapsed()))
+				{
+					break;
+				}
+
+				replayFrame(relative);
+				mNextFrameTimestampValid = false;
+			}
+		}
+
+		mMouseState.X.rel = relative.X.rel;
+		mMouseState.Y.rel = relative.Y.rel;
+		mMouseState.Z.rel = relative.Z.rel;
+	}
+
+	const OIS::MouseState &ReplayInputSource::getMouseState() const
+	{
+		return mMouseState;
+	}
+
+	void ReplayInputSource::setMouseArea(int aWidth, int aHeight)
+	{
+		// positions are replayed as recorded; the area is only reported
+		mMouseState.width = aWidth;
+		mMouseState.height = aHeight;
+	}
+
+	bool ReplayInputSource::isFinished() const
+	{
+		return mStream.atEnd();
+	}
+
+	void ReplayInputSource::replayFrame(OIS::MouseState &aRelative)
+	{
+		while (!mStream.atEnd())
+		{
+			quint8 type = 0;
+			mStream >> type;
+
+			switch (type)
+			{
+			case InputRecording::MouseMoved:
+			case InputRecording::MousePressed:
+			case InputRecording::MouseReleased:
+			{
+				OIS::MouseState state = mMouseState;
+				InputRecording::readMouseState(mStream, state);
+				quint8 button = 0;
+				mStream >> button;
+
+				if (mMouseListener)
+				{
+					OIS::MouseEvent event(NULL, state);
+					if (type == InputRecording::MouseMoved)
+					{
+						mMouseListener->mouseMoved(event);
+					}
+					else if (type == InputRecording::MousePressed)
+					{
+						mMouseListener->mousePressed(event, OIS::MouseButtonID(button));
+					}
+					else
+					{
+						mMouseListener->mouseReleased(event, OIS::MouseButtonID(button));
+					}
+				}
+				break;
+			}
+			case InputRecording::KeyPressed:
+			case InputRecording::KeyReleased:
+			{
+				quint8 key = 0;
+				quint32 text = 0;
+				mStream >> key >> text;
+
+				if (mKeyListener)
+				{
+					OIS::KeyEvent event(NULL, OIS::KeyCode(key), text);
+					if (type == InputRecording::KeyPressed)
+					{
+						mKeyListener->keyPressed(event);
+					}
+					else
+					{
+						mKeyListener->keyReleased(event);
+					}
+				}
+				break;
+			}
+			case InputRecording::Frame:
+			{
+				quint32 frameIndex = 0;
+				quint32 timestamp = 0;
+				mStream >> frameIndex >> timestamp;
+				InputRecording::readMouseState(mStream, mMouseState);
+
+				aRelative.X.rel += mMouseState.X.rel;
+				aRelative.Y.rel += mMouseState.Y.rel;
+				aRelative.Z.rel += mMouseState.Z.rel;
+
+				mLastFrameDuration = (mFrameCount > 0) ? timestamp - mLastFrameTimestamp : 0;
+				mLastFrameTimestamp = timestamp;
+				++mFrameCount;
+				return;
+			}
+			default:
+				EXCEPTION("Corrupt input recording.", "ReplayInputSource::replayFrame()");
+			}
+		}
+	}
+
+	bool ReplayInputSource::peekNextFrameTimestamp(quint32 &aTimestamp)
+	{
+		const qint64 position = mFile.pos();
+		bool found = false;
+
+		while (!found && !mStream.atEnd())
+		{
+			quint8 type = 0;
+			mStream >> type;
+
+			switch (type)
+			{
+			case InputRecording::MouseMoved:
+			case InputRecording::MousePressed:
+			case InputRecording::MouseReleased:
+				mStream.skipRawData(InputRecording::MOUSE_RECORD_SIZE);
+				break;
+			case InputRecording::KeyPressed:
+			case InputRecording::KeyReleased:
+				mStream.skipRawData(InputRecording::KEY_RECORD_SIZE);
+				break;
+			case InputRecording::Frame:
+			{
+				quint32 frameIndex = 0;
+				mStream >> frameIndex >> aTimestamp;
+				found = true;
+				break;
+			}
+			default:
+				EXCEPTION("Corrupt input recording.", "ReplayInputSource::peekNextFrameTimestamp()");
+			}
+		}
+
+		mFile.seek(position);
+		mStream.resetStatus();
+
+		return found;
+	}
+}
@@ -0,0 +1,212 @@
+/** This file is part of Cutexture.
+ 
+ Copyright (c) 2010 Markus Weiland, Kevin Lang
+
+ Portions of this code may be under copyright of authors listed in AUTHORS.
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+#include "ResourceLoader.h"
+
+namespace Cutexture
+{
+	ResourceLoader::ResourceLoader(QObject *aParent) :
+		QObject(aParent), mState(StateIdle), mLoadedCount(0), mTotalCount(0), mNextGroup(0),
+				mPendingPreparations(0)
+	{
+	}
+	
+	ResourceLoader::~ResourceLoader()
+	{
+	}
+	
+	void ResourceLoader::addGroup(const Ogre::String &aGroup)
+	{
+		assert(mState == StateIdle);
+		
+		mGroups.push_back(aGroup);
+	}
+	
+	void ResourceLoader::addAllGroups()
+	{
+		Ogre::ResourceGroupManager &groupManager = Ogre::ResourceGroupManager::getSingleton();
+		Ogre::StringVector groups = groupManager.getResourceGroups();
+		
+		for (Ogre::StringVector::const_iterator it = groups.begin(); it != groups.end(); ++it)
+		{
+			if (!groupManager.isResourceGroupLoaded(*it))
+			{
+				addGroup(*it);
+			}
+		}
+	}
+	
+	void ResourceLoader::start()
+	{
+		assert(mState == StateIdle);
+		
+		mNextGroup = 0;
+		mLoadedCount = 0;
+		mTotalCount = 0;
+		mState = StateInitialising;
+	}
+	
+	bool ResourceLoader::tick(int aBudget)
+	{
+		Ogre::ResourceGroupManager &groupManager = Ogre::ResourceGroupManager::getSingleton();
+		
+		QTime budget;
+		budget.start();
+		
+		do
+		{
+			switch (int(mState))
+			{
+				case StateIdle:
+				case StateFinished:
+					return false;
+					
+				case StateInitialising:
+					if (mNextGroup < int(mGroups.size()))
+					{
+						// parses the scripts of the group at once, it cannot be split up
+						const Ogre::String &group = mGroups.at(mNextGroup++);
+						if (!groupManager.isResourceGroupInitialised(group))
+						{
+							groupManager.initialiseResourceGroup(group);
+						}
+						
+						emit progressChanged(0, 0, QString("Initialising %1").arg(
+								QString::fromStdString(group)));
+					}
+					else
+					{
+						collectResources();
+						
+						const bool preparing = startPreparing();
+						mState = (preparing && mPendingPreparations > 0) ? StatePreparing : StateLoading;
+					}
+					break;
+					
+				case StatePreparing:
+					// Ogre only delivers operationCompleted() from its work queue while it
+					// renders a frame, but no frames are rendered while the window is hidden
+					Ogre::Root::getSingleton().getWorkQueue()->processResponses();
+					if (mState == StatePreparing)
+					{
+						return true;
+					}
+					break;
+					
+				case StateLoading:
+					if (mLoadedCount < mResources.size())
+					{
+						Ogre::ResourcePtr resource = mResources.at(mLoadedCount);
+						resource->load();
+						
+						mLoadedCount.ref();
+						emit progressChanged(mLoadedCount, mTotalCount, QString::fromStdString(
+								resource->getName()));
+					}
+					else
+					{
+						// marks the groups as loaded; their resources already are
+						for (Ogre::StringVector::const_iterator it = mGroups.begin(); it
+								!= mGroups.end(); ++it)
+						{
+							groupManager.loadResourceGroup(*it);
+						}
+						
+						mResources.clear();
+						mState = StateFinished;
+						emit finished();
+						return false;
+					}
+					break;
+			}
+		} while (budget.elapsed() < aBudget);
+		
+		return true;
+	}
+	
+	bool ResourceLoader::isLoading() const
+	{
+		return (mState != StateIdle && mState != StateFinished);
+	}
+	
+	void ResourceLoader::operationCompleted(Ogre::BackgroundProcessTicket aTicket,
+			const Ogre::BackgroundProcessResult &aResult)
+	{
+		if (aResult.error)
+		{
+			// the resource is loaded, and the error reported, on the main thread instead
+			Ogre::LogManager::getSingleton().logMessage("Preparing resources in the background failed: "
+					+ aResult.message);
+		}
+		
+		if (--mPendingPreparations == 0 && mState == StatePreparing)
+		{
+			mState = StateLoading;
+		}
+	}
+	
+	void ResourceLoader::collectResources()
+	{
+		mResources.clear();
+		
+		Ogre::ResourceGroupManager::ResourceManagerIterator managers =
+				Ogre::ResourceGroupManager::getSingleton().getResourceManagerIterator();
+		
+		while (managers.hasMoreElements())
+		{
+			Ogre::ResourceManager::ResourceMapIterator resources =
+					managers.getNext()->getResourceIterator();
+			
+			while (resources.hasMoreElements())
+			{
+				Ogre::ResourcePtr resource = resources.getNext();
+				
+				if (!resource->isLoaded() && std::find(mGroups.begin(), mGroups.end(),
+						resource->getGroup()) != mGroups.end())
+				{
+					mResources.append(resource);
+				}
+			}
+		}
+		
+		mTotalCount = mResources.size();
+	}
+	
+	bool ResourceLoader::startPreparing()
+	{
+#if OGRE_THREAD_SUPPORT
+		mPendingPreparations = int(mGroups.size());
+		
+		for (Ogre::StringVector::const_iterator it = mGroups.begin(); it != mGroups.end(); ++it)
+		{
+			Ogre::ResourceBackgroundQueue::getSingleton().prepareResourceGroup(*it, this);
+		}
+		
+		return (mPendingPreparations > 0);
+#else
+		return false;
+#endif
+	}
+}
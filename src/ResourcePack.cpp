@@ -0,0 +1,288 @@
+/** This file is part of Cutexture.
+ 
+ Copyright (c) 2010 Markus Weiland, Kevin Lang
+
+ Portions of this code may be under copyright of authors listed in AUTHORS.
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+#include "ResourcePack.h"
+#include "Constants.h"
+
+namespace Cutexture
+{
+	ResourcePack::ResourcePack() :
+		mData(NULL), mDataSize(0)
+	{
+	}
+	
+	ResourcePack::~ResourcePack()
+	{
+		close();
+	}
+	
+	bool ResourcePack::open(const QString &aFileName)
+	{
+		close();
+		
+		mFile.setFileName(aFileName);
+		if (!mFile.open(QFile::ReadOnly))
+		{
+			return false;
+		}
+		
+		mDataSize = mFile.size();
+		mData = mFile.map(0, mDataSize);
+		
+		if (!mData || !readIndex())
+		{
+			close();
+			return false;
+		}
+		
+		return true;
+	}
+	
+	void ResourcePack::close()
+	{
+		mEntries.clear();
+		
+		if (mData)
+		{
+			mFile.unmap(mData);
+			mData = NULL;
+		}
+		
+		mDataSize = 0;
+		mFile.close();
+	}
+	
+	bool ResourcePack::contains(const QString &aName) const
+	{
+		return mEntries.contains(aName);
+	}
+	
+	QStringList ResourcePack::getEntryNames() const
+	{
+		return mEntries.keys();
+	}
+	
+	qint64 ResourcePack::getSize(const QString &aName) const
+	{
+		QHash<QString, Entry>::const_iterator it = mEntries.constFind(aName);
+		return (it != mEntries.constEnd()) ? it->size : -1;
+	}
+	
+	qint64 ResourcePack::getStoredSize(const QString &aName) const
+	{
+		QHash<QString, Entry>::const_iterator it = mEntries.constFind(aName);
+		return (it != mEntries.constEnd()) ? it->storedSize : -1;
+	}
+	
+	bool ResourcePack::isCompressed(const QString &aName) const
+	{
+		return (mEntries.value(aName).flags & ENTRY_COMPRESSED);
+	}
+	
+	const uchar* ResourcePack::map(const QString &aName) const
+	{
+		QHash<QString, Entry>::const_iterator it = mEntries.constFind(aName);
+		if (it == mEntries.constEnd() || (it->flags & ENTRY_COMPRESSED))
+		{
+			return NULL;
+		}
+		
+		return mData + it->offset;
+	}
+	
+	QByteArray ResourcePack::read(const QString &aName) const
+	{
+		QHash<QString, Entry>::const_iterator it = mEntries.constFind(aName);
+		if (it == mEntries.constEnd())
+		{
+			return QByteArray();
+		}
+		
+		if (it->flags & ENTRY_COMPRESSED)
+		{
+			return qUncompress(mData + it->offset, int(it->storedSize));
+		}
+		
+		return QByteArray::fromRawData(reinterpret_cast<const char *> (mData + it->offset),
+				int(it->size));
+	}
+	
+	bool ResourcePack::readIndex()
+	{
+		if (mDataSize < Constants::RESOURCE_PACK_HEADER_SIZE)
+		{
+			return false;
+		}
+		
+		const QByteArray header = QByteArray::fromRawData(reinterpret_cast<const char *> (mData),
+				Constants::RESOURCE_PACK_HEADER_SIZE);
+		QDataStream headerStream(header);
+		headerStream.setByteOrder(QDataStream::LittleEndian);
+		
+		quint32 magic, version, entryCount, reserved;
+		quint64 indexOffset, indexSize;
+		headerStream >> magic >> version >> entryCount >> reserved >> indexOffset >> indexSize;
+		
+		if (magic != Constants::RESOURCE_PACK_MAGIC || version != Constants::RESOURCE_PACK_VERSION
+				|| indexOffset > quint64(mDataSize) || indexSize > quint64(mDataSize) - indexOffset)
+		{
+			return false;
+		}
+		
+		const QByteArray index = QByteArray::fromRawData(reinterpret_cast<const char *> (mData
+				+ indexOffset), int(indexSize));
+		QDataStream indexStream(index);
+		indexStream.setByteOrder(QDataStream::LittleEndian);
+		
+		for (quint32 i = 0; i < entryCount; ++i)
+		{
+			QByteArray name;
+			quint64 offset, storedSize, size;
+			Entry entry;
+			
+			indexStream >> name >> offset >> storedSize >> size >> entry.flags;
+			
+			if (indexStream.status() != QDataStream::Ok || offset > quint64(mDataSize)
+					|| storedSize > quint64(mDataSize) - offset)
+			{
+				return false;
+			}
+			
+			// uncompressed entries are read with their size straight from the mapping
+			if (!(entry.flags & ENTRY_COMPRESSED) && size != storedSize)
+			{
+				return false;
+			}
+			
+			entry.offset = offset;
+			entry.storedSize = storedSize;
+			entry.size = size;
+			mEntries.insert(QString::fromUtf8(name), entry);
+		}
+		
+		return true;
+	}
+	
+	ResourcePackWriter::ResourcePackWriter()
+	{
+	}
+	
+	ResourcePackWriter::~ResourcePackWriter()
+	{
+	}
+	
+	void ResourcePackWriter::addEntry(const QString &aName, const QByteArray &aData, bool aCompress)
+	{
+		PendingEntry entry;
+		entry.data = aData;
+		entry.size = aData.size();
+		entry.compressed = false;
+		
+		if (aCompress)
+		{
+			const QByteArray compressed = qCompress(aData);
+			if (compressed.size() <= aData.size() - aData.size() / 4)
+			{
+				entry.data = compressed;
+				entry.compressed = true;
+			}
+		}
+		
+		mEntries.insert(aName, entry);
+	}
+	
+	bool ResourcePackWriter::addFile(const QString &aName, const QString &aFileName, bool aCompress)
+	{
+		QFile file(aFileName);
+		if (!file.open(QFile::ReadOnly))
+		{
+			return false;
+		}
+		
+		addEntry(aName, file.readAll(), aCompress);
+		return true;
+	}
+	
+	bool ResourcePackWriter::write(const QString &aFileName) const
+	{
+		QFile file(aFileName);
+		if (!file.open(QFile::WriteOnly | QFile::Truncate))
+		{
+			return false;
+		}
+		
+		QByteArray index;
+		QDataStream indexStream(&index, QIODevice::WriteOnly);
+		indexStream.setByteOrder(QDataStream::LittleEndian);
+		
+		// the header is filled in last, once the index position is known
+		qint64 offset = Constants::RESOURCE_PACK_HEADER_SIZE;
+		if (file.write(QByteArray(Constants::RESOURCE_PACK_HEADER_SIZE, '\0')) != offset)
+		{
+			return false;
+		}
+		
+		for (QMap<QString, PendingEntry>::const_iterator it = mEntries.constBegin(); it
+				!= mEntries.constEnd(); ++it)
+		{
+			// uncompressed entries are used in place, so they start on a page of their own
+			if (!it->compressed)
+			{
+				const qint64 alignedOffset = (offset + Constants::RESOURCE_PACK_ALIGNMENT - 1)
+						/ Constants::RESOURCE_PACK_ALIGNMENT * Constants::RESOURCE_PACK_ALIGNMENT;
+				const QByteArray padding(int(alignedOffset - offset), '\0');
+				
+				if (file.write(padding) != padding.size())
+				{
+					return false;
+				}
+				offset = alignedOffset;
+			}
+			
+			if (file.write(it->data) != it->data.size())
+			{
+				return false;
+			}
+			
+			indexStream << it.key().toUtf8() << quint64(offset) << quint64(it->data.size())
+					<< quint64(it->size) << quint32(it->compressed ? ResourcePack::ENTRY_COMPRESSED : 0);
+			
+			offset += it->data.size();
+		}
+		
+		if (file.write(index) != index.size())
+		{
+			return false;
+		}
+		
+		QByteArray header;
+		QDataStream headerStream(&header, QIODevice::WriteOnly);
+		headerStream.setByteOrder(QDataStream::LittleEndian);
+		headerStream << Constants::RESOURCE_PACK_MAGIC << Constants::RESOURCE_PACK_VERSION
+				<< quint32(mEntries.size()) << quint32(0) << quint64(offset) << quint64(index.size());
+		
+		return (file.seek(0) && file.write(header) == header.size() && file.flush());
+	}
+}
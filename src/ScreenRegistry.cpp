@@ -0,0 +1,220 @@
+/** This file is part of Cutexture.
+ 
+ Copyright (c) 2010 Markus Weiland, Kevin Lang
+
+ Portions of this code may be under copyright of authors listed in AUTHORS.
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+#include "ScreenRegistry.h"
+#include "UiManager.h"
+#include "Constants.h"
+#include "Exception.h"
+
+namespace Cutexture
+{
+	ScreenRegistry::ScreenRegistry(UiManager *aUiManager) :
+		mUiManager(aUiManager), mMaxPoolCost(Constants::UI_SCREEN_POOL_MAX_COST), mUseCounter(0)
+	{
+		assert(mUiManager);
+	}
+	
+	ScreenRegistry::~ScreenRegistry()
+	{
+		// the active screen stays with the UiManager
+		for (QHash<QString, Screen>::iterator it = mScreens.begin(); it != mScreens.end(); ++it)
+		{
+			if (it->widget)
+			{
+				mUiManager->releaseWidget(it->widget);
+			}
+		}
+	}
+	
+	void ScreenRegistry::registerScreen(const QString &aName, const QString &aUiFile)
+	{
+		QFile file(aUiFile);
+		if (!file.open(QFile::ReadOnly))
+		{
+			EXCEPTION("Cannot read UI file '" + aUiFile.toStdString() + "'.", "ScreenRegistry::registerScreen()");
+		}
+		
+		registerScreen(aName, file.readAll());
+	}
+	
+	void ScreenRegistry::registerScreen(const QString &aName, const QByteArray &aForm)
+	{
+		if (mScreens.contains(aName) && mScreens.value(aName).widget)
+		{
+			EXCEPTION("Screen '" + aName.toStdString() + "' is already built.", "ScreenRegistry::registerScreen()");
+		}
+		
+		Screen screen;
+		screen.form = aForm;
+		screen.widget = NULL;
+		screen.cost = 0;
+		screen.lastUsed = 0;
+		
+		mScreens.insert(aName, screen);
+	}
+	
+	QWidget* ScreenRegistry::showScreen(const QString &aName)
+	{
+		Screen &screen = findScreen(aName);
+		build(screen);
+		
+		// the previous screen has been laid out while it was shown
+		QHash<QString, Screen>::iterator previous = mScreens.find(mActiveScreen);
+		if (previous != mScreens.end() && previous->widget && previous.key() != aName)
+		{
+			previous->cost = estimateCost(previous->widget);
+		}
+		
+		screen.lastUsed = ++mUseCounter;
+		mActiveScreen = aName;
+		mUiManager->setActiveWidget(screen.widget);
+		
+		// the previous screen is hidden now
+		trimPool();
+		
+		return screen.widget;
+	}
+	
+	QWidget* ScreenRegistry::getScreen(const QString &aName)
+	{
+		Screen &screen = findScreen(aName);
+		build(screen);
+		
+		screen.lastUsed = ++mUseCounter;
+		trimPool(&screen);
+		
+		return screen.widget;
+	}
+	
+	void ScreenRegistry::prewarmScreen(const QString &aName)
+	{
+		Screen &screen = findScreen(aName);
+		mUiManager->prewarmWidget(getScreen(aName));
+		
+		// prewarming laid the screen out at the size it is shown at
+		screen.cost = estimateCost(screen.widget);
+		trimPool(&screen);
+	}
+	
+	void ScreenRegistry::prewarmAll()
+	{
+		foreach(const QString &name, mScreens.keys())
+		{
+			prewarmScreen(name);
+		}
+	}
+	
+	void ScreenRegistry::setMaxPoolCost(qint64 aBytes)
+	{
+		mMaxPoolCost = aBytes;
+		trimPool();
+	}
+	
+	qint64 ScreenRegistry::getPoolCost() const
+	{
+		qint64 cost = 0;
+		
+		for (QHash<QString, Screen>::const_iterator it = mScreens.constBegin(); it != mScreens.constEnd(); ++it)
+		{
+			if (it->widget && it.key() != mActiveScreen)
+			{
+				cost += it->cost;
+			}
+		}
+		
+		return cost;
+	}
+	
+	ScreenRegistry::Screen& ScreenRegistry::findScreen(const QString &aName)
+	{
+		QHash<QString, Screen>::iterator it = mScreens.find(aName);
+		if (it == mScreens.end())
+		{
+			EXCEPTION("Unknown screen '" + aName.toStdString() + "'.", "ScreenRegistry::findScreen()");
+		}
+		
+		return it.value();
+	}
+	
+	void ScreenRegistry::build(Screen &aScreen)
+	{
+		if (aScreen.widget)
+		{
+			return;
+		}
+		
+		QBuffer buffer(&aScreen.form);
+		buffer.open(QIODevice::ReadOnly);
+		
+		QUiLoader uiLoader;
+		aScreen.widget = uiLoader.load(&buffer);
+		
+		if (!aScreen.widget)
+		{
+			EXCEPTION("Cannot build screen from its UI file.", "ScreenRegistry::build()");
+		}
+		
+		// provisional until the screen has been laid out
+		aScreen.cost = estimateCost(aScreen.widget);
+		mUiManager->retainWidget(aScreen.widget);
+	}
+	
+	void ScreenRegistry::trimPool(const Screen *aKeep)
+	{
+		qint64 poolCost = getPoolCost();
+		
+		while (poolCost > mMaxPoolCost)
+		{
+			Screen *oldest = NULL;
+			
+			for (QHash<QString, Screen>::iterator it = mScreens.begin(); it != mScreens.end(); ++it)
+			{
+				if (it->widget && it.key() != mActiveScreen && &it.value() != aKeep && (!oldest
+						|| it->lastUsed < oldest->lastUsed))
+				{
+					oldest = &it.value();
+				}
+			}
+			
+			if (!oldest)
+			{
+				break;
+			}
+			
+			mUiManager->releaseWidget(oldest->widget);
+			oldest->widget = NULL;
+			poolCost -= oldest->cost;
+		}
+	}
+	
+	qint64 ScreenRegistry::estimateCost(QWidget *aWidget)
+	{
+		// children are painted into the cache of the top-level widget
+		const int widgetCount = aWidget->findChildren<QWidget *> ().size() + 1;
+		
+		return qint64(aWidget->width()) * aWidget->height() * 4 + widgetCount
+				* Constants::UI_SCREEN_WIDGET_COST;
+	}
+}
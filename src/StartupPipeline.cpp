@@ -0,0 +1,268 @@
+/** This file is part of Cutexture.
+ 
+ Copyright (c) 2010 Markus Weiland, Kevin Lang
+
+ Portions of this code may be under copyright of authors listed in AUTHORS.
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+#include "StartupPipeline.h"
+#include "Exception.h"
+
+namespace Cutexture
+{
+	StartupPipeline::StartupPipeline() :
+		mTotalDuration(0)
+	{
+	}
+	
+	StartupPipeline::~StartupPipeline()
+	{
+	}
+	
+	void StartupPipeline::addStep(const QString &aName, QObject *aReceiver, const char *aMethod,
+			const QStringList &aDependencies, bool aWorkerThread)
+	{
+		assert(aReceiver && aMethod);
+		
+		Step step;
+		step.name = aName;
+		step.receiver = aReceiver;
+		step.method = aMethod;
+		step.dependencies = aDependencies;
+		step.workerThread = aWorkerThread;
+		step.state = StepPending;
+		step.startTime = -1;
+		step.duration = -1;
+		
+		mSteps.append(step);
+	}
+	
+	void StartupPipeline::run()
+	{
+		for (int i = 0; i < mSteps.size(); ++i)
+		{
+			mSteps[i].state = StepPending;
+			mSteps[i].error.clear();
+		}
+		
+		mClock.start();
+		
+		QList<QFuture<void> > workers;
+		int runningWorkers = 0;
+		int finishedSteps = 0;
+		QString error;
+		
+		while (finishedSteps < mSteps.size())
+		{
+			// hand out everything that became ready, preferring to keep the workers busy
+			int mainThreadStep = -1;
+			QMutexLocker locker(&mMutex);
+			
+			for (int i = 0; i < mSteps.size() && error.isEmpty(); ++i)
+			{
+				Step &step = mSteps[i];
+				if (step.state != StepPending || !isReady(step))
+				{
+					continue;
+				}
+				
+				if (step.workerThread)
+				{
+					step.state = StepRunning;
+					++runningWorkers;
+					workers.append(QtConcurrent::run(this, &StartupPipeline::runStep, i));
+				}
+				else if (mainThreadStep < 0)
+				{
+					mainThreadStep = i;
+				}
+			}
+			
+			if (mainThreadStep >= 0)
+			{
+				mSteps[mainThreadStep].state = StepRunning;
+				locker.unlock();
+				
+				runStep(mainThreadStep);
+				++finishedSteps;
+				
+				if (error.isEmpty())
+				{
+					error = mSteps.at(mainThreadStep).error;
+				}
+				continue;
+			}
+			
+			if (runningWorkers == 0)
+			{
+				if (error.isEmpty())
+				{
+					error = "Unsatisfiable dependencies between the startup steps.";
+				}
+				break;
+			}
+			
+			locker.unlock();
+			mWorkerFinished.acquire();
+			--runningWorkers;
+			++finishedSteps;
+			
+			locker.relock();
+			for (int i = 0; i < mSteps.size() && error.isEmpty(); ++i)
+			{
+				if (mSteps.at(i).workerThread && mSteps.at(i).state == StepFinished)
+				{
+					error = mSteps.at(i).error;
+				}
+			}
+			
+			if (!error.isEmpty())
+			{
+				break;
+			}
+		}
+		
+		// never leave workers behind which use objects of the caller
+		foreach(QFuture<void> worker, workers)
+		{
+			worker.waitForFinished();
+		}
+		
+		mTotalDuration = mClock.elapsed();
+		logTimings();
+		
+		if (!error.isEmpty())
+		{
+			EXCEPTION(error.toStdString(), "StartupPipeline::run()");
+		}
+	}
+	
+	int StartupPipeline::getStepDuration(const QString &aName) const
+	{
+		foreach(const Step &step, mSteps)
+		{
+			if (step.name == aName)
+			{
+				return step.duration;
+			}
+		}
+		
+		return -1;
+	}
+	
+	void StartupPipeline::runStep(int aIndex)
+	{
+		QMutexLocker locker(&mMutex);
+		Step &step = mSteps[aIndex];
+		QObject *receiver = step.receiver;
+		const QByteArray method = step.method;
+		const bool workerThread = step.workerThread;
+		locker.unlock();
+		
+		const int startTime = mClock.elapsed();
+		QString error;
+		
+		try
+		{
+			if (!QMetaObject::invokeMethod(receiver, method.constData(), Qt::DirectConnection))
+			{
+				error = "Cannot invoke startup step method '" + QString(method) + "'.";
+			}
+		}
+		catch (const Exception &e)
+		{
+			error = QString::fromStdString(e.getFullDescription());
+		}
+		catch (const std::exception &e)
+		{
+			error = e.what();
+		}
+		
+		const int duration = mClock.elapsed() - startTime;
+		
+		locker.relock();
+		step.startTime = startTime;
+		step.duration = duration;
+		step.error = error;
+		step.state = StepFinished;
+		locker.unlock();
+		
+		if (workerThread)
+		{
+			mWorkerFinished.release();
+		}
+	}
+	
+	bool StartupPipeline::isReady(const Step &aStep) const
+	{
+		foreach(const QString &dependency, aStep.dependencies)
+		{
+			bool finished = false;
+			
+			foreach(const Step &step, mSteps)
+			{
+				if (step.name == dependency)
+				{
+					finished = (step.state == StepFinished && step.error.isEmpty());
+					break;
+				}
+			}
+			
+			if (!finished)
+			{
+				return false;
+			}
+		}
+		
+		return true;
+	}
+	
+	void StartupPipeline::logTimings() const
+	{
+		QStringList lines;
+		lines << QString("Startup took %1 ms:").arg(mTotalDuration);
+		
+		foreach(const Step &step, mSteps)
+		{
+			if (step.state != StepFinished)
+			{
+				lines << QString("  %1: not run").arg(step.name);
+				continue;
+			}
+			
+			lines << QString("  %1: %2 ms, started at %3 ms on the %4 thread").arg(step.name).arg(
+					step.duration).arg(step.startTime).arg(step.workerThread ? "worker" : "main");
+		}
+		
+		// Ogre's log only exists once Ogre::Root has been created
+		foreach(const QString &line, lines)
+		{
+			if (Ogre::LogManager::getSingletonPtr())
+			{
+				Ogre::LogManager::getSingleton().logMessage(line.toStdString());
+			}
+			else
+			{
+				qDebug() << line;
+			}
+		}
+	}
+}
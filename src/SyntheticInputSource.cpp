@@ -0,0 +1,170 @@
+/** This file is part of Cutexture.
+ 
+ Copyright (c) 2010 Markus Weiland, Kevin Lang
+
+ Portions of this code may be under copyright of authors listed in AUTHORS.
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+#include "SyntheticInputSource.h"
+
+namespace Cutexture
+{
+	SyntheticInputSource::SyntheticInputSource(const QSize &aMouseArea) :
+		mMouseListener(NULL), mKeyListener(NULL)
+	{
+		mMouseState.clear();
+		setMouseArea(aMouseArea.width(), aMouseArea.height());
+	}
+
+	SyntheticInputSource::~SyntheticInputSource()
+	{
+	}
+
+	void SyntheticInputSource::setEventCallbacks(OIS::MouseListener *aMouseListener,
+			OIS::KeyListener *aKeyListener)
+	{
+		mMouseListener = aMouseListener;
+		mKeyListener = aKeyListener;
+	}
+
+	void SyntheticInputSource::capture()
+	{
+		// like an OIS mouse, relative values only span one capture
+		mMouseState.X.rel = 0;
+		mMouseState.Y.rel = 0;
+		mMouseState.Z.rel = 0;
+
+		// listeners may inject new events; those are delivered on the next capture
+		QVector<SyntheticEvent> events;
+		events.swap(mPendingEvents);
+
+		for (QVector<SyntheticEvent>::const_iterator i = events.constBegin(); i != events.constEnd(); ++i)
+		{
+			const SyntheticEvent &event = *i;
+			switch (event.type)
+			{
+			case MouseMove:
+			{
+				int newX = qBound(0, event.x, mMouseState.width);
+				int newY = qBound(0, event.y, mMouseState.height);
+				mMouseState.X.rel += newX - mMouseState.X.abs;
+				mMouseState.Y.rel += newY - mMouseState.Y.abs;
+				mMouseState.X.abs = newX;
+				mMouseState.Y.abs = newY;
+				if (mMouseListener)
+				{
+					mMouseListener->mouseMoved(OIS::MouseEvent(NULL, mMouseState));
+				}
+				break;
+			}
+			case MouseWheel:
+				mMouseState.Z.rel += event.z;
+				mMouseState.Z.abs += event.z;
+				if (mMouseListener)
+				{
+					mMouseListener->mouseMoved(OIS::MouseEvent(NULL, mMouseState));
+				}
+				break;
+			case MousePress:
+				mMouseState.buttons |= 1 << event.button;
+				if (mMouseListener)
+				{
+					mMouseListener->mousePressed(OIS::MouseEvent(NULL, mMouseState), event.button);
+				}
+				break;
+			case MouseRelease:
+				mMouseState.buttons &= ~(1 << event.button);
+				if (mMouseListener)
+				{
+					mMouseListener->mouseReleased(OIS::MouseEvent(NULL, mMouseState), event.button);
+				}
+				break;
+			case KeyPress:
+				if (mKeyListener)
+				{
+					mKeyListener->keyPressed(OIS::KeyEvent(NULL, event.key, event.text));
+				}
+				break;
+			case KeyRelease:
+				if (mKeyListener)
+				{
+					mKeyListener->keyReleased(OIS::KeyEvent(NULL, event.key, event.text));
+				}
+				break;
+			}
+		}
+	}
+
+	const OIS::MouseState &SyntheticInputSource::getMouseState() const
+	{
+		return mMouseState;
+	}
+
+	void SyntheticInputSource::setMouseArea(int aWidth, int aHeight)
+	{
+		mMouseState.width = aWidth;
+		mMouseState.height = aHeight;
+	}
+
+	void SyntheticInputSource::injectMouseMove(int aX, int aY)
+	{
+		queueEvent(MouseMove, aX, aY, 0, OIS::MB_Left, OIS::KC_UNASSIGNED, 0);
+	}
+
+	void SyntheticInputSource::injectMouseWheel(int aDelta)
+	{
+		queueEvent(MouseWheel, 0, 0, aDelta, OIS::MB_Left, OIS::KC_UNASSIGNED, 0);
+	}
+
+	void SyntheticInputSource::injectMousePress(OIS::MouseButtonID aButton)
+	{
+		queueEvent(MousePress, 0, 0, 0, aButton, OIS::KC_UNASSIGNED, 0);
+	}
+
+	void SyntheticInputSource::injectMouseRelease(OIS::MouseButtonID aButton)
+	{
+		queueEvent(MouseRelease, 0, 0, 0, aButton, OIS::KC_UNASSIGNED, 0);
+	}
+
+	void SyntheticInputSource::injectKeyPress(OIS::KeyCode aKey, unsigned int aText)
+	{
+		queueEvent(KeyPress, 0, 0, 0, OIS::MB_Left, aKey, aText);
+	}
+
+	void SyntheticInputSource::injectKeyRelease(OIS::KeyCode aKey, unsigned int aText)
+	{
+		queueEvent(KeyRelease, 0, 0, 0, OIS::MB_Left, aKey, aText);
+	}
+
+	void SyntheticInputSource::queueEvent(EventType aType, int aX, int aY, int aZ,
+			OIS::MouseButtonID aButton, OIS::KeyCode aKey, unsigned int aText)
+	{
+		SyntheticEvent event;
+		event.type = aType;
+		event.x = aX;
+		event.y = aY;
+		event.z = aZ;
+		event.button = aButton;
+		event.key = aKey;
+		event.text = aText;
+		mPendingEvents.append(event);
+	}
+}
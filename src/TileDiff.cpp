@@ -0,0 +1,195 @@
+/** This file is part of Cutexture.
+ 
+ Copyright (c) 2010 Markus Weiland, Kevin Lang
+
+ Portions of this code may be under copyright of authors listed in AUTHORS.
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+#include "TileDiff.h"
+
+#include <cstring>
+
+namespace
+{
+	// the primes of xxHash64
+	const quint64 HASH_PRIME1 = Q_UINT64_C(0x9e3779b185ebca87);
+	const quint64 HASH_PRIME2 = Q_UINT64_C(0xc2b2ae3d27d4eb4f);
+	const quint64 HASH_PRIME3 = Q_UINT64_C(0x165667b19e3779f9);
+	const quint64 HASH_PRIME4 = Q_UINT64_C(0x85ebca77c2b2ae63);
+
+	/** Loads 8 bytes without alignment requirements. Compiles to a
+	 * single load on x86. */
+	inline quint64 loadWord(const uchar *aData)
+	{
+		quint64 word;
+		std::memcpy(&word, aData, sizeof(word));
+		return word;
+	}
+
+	inline quint64 rotateLeft(quint64 aValue, int aBits)
+	{
+		return (aValue << aBits) | (aValue >> (64 - aBits));
+	}
+
+	/** Mixes aInput into aLane like an xxHash64 round. For a fixed
+	 * lane, every input gives a different result and vice versa,
+	 * so a change in any bit of the input reaches the hash. */
+	inline quint64 mixRound(quint64 aLane, quint64 aInput)
+	{
+		return rotateLeft(aLane + aInput * HASH_PRIME2, 31) * HASH_PRIME1;
+	}
+
+	/** Folds aLane into aHash; one-to-one in either argument. */
+	inline quint64 mergeLane(quint64 aHash, quint64 aLane)
+	{
+		return rotateLeft(aHash ^ mixRound(0, aLane), 27) * HASH_PRIME1 + HASH_PRIME4;
+	}
+
+	/** The xxHash64 finalizer, spreads every bit over the whole
+	 * hash. */
+	inline quint64 avalanche(quint64 aHash)
+	{
+		aHash ^= aHash >> 33;
+		aHash *= HASH_PRIME2;
+		aHash ^= aHash >> 29;
+		aHash *= HASH_PRIME3;
+		aHash ^= aHash >> 32;
+		return aHash;
+	}
+}
+
+namespace Cutexture
+{
+	TileDiff::TileDiff(int aTileSize) :
+		mTileSize(aTileSize)
+	{
+		assert(aTileSize > 0);
+	}
+
+	TileDiff::~TileDiff()
+	{
+	}
+
+	QVector<QRect> TileDiff::update(const QImage &aImage)
+	{
+		const int tilesX = (aImage.width() + mTileSize - 1) / mTileSize;
+		const int tilesY = (aImage.height() + mTileSize - 1) / mTileSize;
+
+		// without valid hashes from the previous frame, everything changed
+		const bool allChanged = (aImage.size() != mImageSize || mTileHashes.size() != tilesX * tilesY);
+		if (allChanged)
+		{
+			mImageSize = aImage.size();
+			mTileHashes.fill(0, tilesX * tilesY);
+		}
+
+		QVector<QRect> changedRects;
+		const QRect imageRect = aImage.rect();
+
+		for (int tileY = 0; tileY < tilesY; ++tileY)
+		{
+			// start of the current run of changed tiles in this row or -1
+			int runStart = -1;
+
+			for (int tileX = 0; tileX <= tilesX; ++tileX)
+			{
+				bool changed = false;
+
+				if (tileX < tilesX)
+				{
+					const QRect tileRect = QRect(tileX * mTileSize, tileY * mTileSize, mTileSize,
+							mTileSize) & imageRect;
+					const quint64 hash = hashRect(aImage, tileRect);
+					quint64 &previousHash = mTileHashes[tileY * tilesX + tileX];
+
+					changed = allChanged || hash != previousHash;
+					previousHash = hash;
+				}
+
+				if (changed && runStart < 0)
+				{
+					runStart = tileX;
+				}
+				else if (!changed && runStart >= 0)
+				{
+					changedRects.append(QRect(runStart * mTileSize, tileY * mTileSize, (tileX
+							- runStart) * mTileSize, mTileSize) & imageRect);
+					runStart = -1;
+				}
+			}
+		}
+
+		return changedRects;
+	}
+
+	void TileDiff::reset()
+	{
+		mImageSize = QSize();
+		mTileHashes.clear();
+	}
+
+	quint64 TileDiff::hashRect(const QImage &aImage, const QRect &aRect)
+	{
+		assert(aImage.depth() == 32);
+
+		// Four independent lanes; they have no dependencies on each other so
+		// the CPU can process them in parallel.
+		quint64 lane0 = HASH_PRIME1 + HASH_PRIME2;
+		quint64 lane1 = HASH_PRIME2;
+		quint64 lane2 = 0;
+		quint64 lane3 = 0 - HASH_PRIME1;
+
+		const int rowBytes = aRect.width() * 4;
+
+		for (int y = aRect.top(); y <= aRect.bottom(); ++y)
+		{
+			const uchar *row = aImage.constScanLine(y) + aRect.left() * 4;
+			int offset = 0;
+
+			for (; offset + 32 <= rowBytes; offset += 32)
+			{
+				lane0 = mixRound(lane0, loadWord(row + offset));
+				lane1 = mixRound(lane1, loadWord(row + offset + 8));
+				lane2 = mixRound(lane2, loadWord(row + offset + 16));
+				lane3 = mixRound(lane3, loadWord(row + offset + 24));
+			}
+
+			for (; offset + 8 <= rowBytes; offset += 8)
+			{
+				lane0 = mixRound(lane0, loadWord(row + offset));
+			}
+
+			// odd pixel at the end of the row
+			if (offset < rowBytes)
+			{
+				quint32 pixel;
+				std::memcpy(&pixel, row + offset, sizeof(pixel));
+				lane1 = mixRound(lane1, pixel);
+			}
+		}
+
+		// a change in a single lane always changes the merged hash
+		quint64 hash = mergeLane(lane0, lane1);
+		hash = mergeLane(hash, lane2);
+		hash = mergeLane(hash, lane3);
+		return avalanche(hash);
+	}
+}
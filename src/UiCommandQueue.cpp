@@ -0,0 +1,158 @@
+/** This file is part of Cutexture.
+ 
+ Copyright (c) 2010 Markus Weiland, Kevin Lang
+
+ Portions of this code may be under copyright of authors listed in AUTHORS.
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+#include "UiCommandQueue.h"
+
+namespace Cutexture
+{
+	UiCommandBatch::UiCommandBatch()
+	{
+	}
+	
+	UiCommandBatch::~UiCommandBatch()
+	{
+	}
+	
+	void UiCommandBatch::setProperty(QObject *aTarget, const char *aProperty, const QVariant &aValue)
+	{
+		assert(aTarget && aProperty);
+		
+		const PropertyKey key(aTarget, QByteArray(aProperty));
+		QHash<PropertyKey, int>::const_iterator existing = mCommandIndices.constFind(key);
+		
+		if (existing != mCommandIndices.constEnd())
+		{
+			mCommands[existing.value()].value = aValue;
+			return;
+		}
+		
+		Command command;
+		command.target = aTarget;
+		command.property = key.second;
+		command.value = aValue;
+		
+		mCommandIndices.insert(key, mCommands.size());
+		mCommands.append(command);
+	}
+	
+	void UiCommandBatch::clear()
+	{
+		mCommands.clear();
+		mCommandIndices.clear();
+	}
+	
+	UiCommandQueue::UiCommandQueue() :
+		mHead(NULL)
+	{
+	}
+	
+	UiCommandQueue::~UiCommandQueue()
+	{
+		Node *node = mHead.fetchAndStoreAcquire(NULL);
+		while (node)
+		{
+			Node *next = node->next;
+			delete node;
+			node = next;
+		}
+	}
+	
+	void UiCommandQueue::post(UiCommandBatch &aBatch)
+	{
+		if (aBatch.isEmpty())
+		{
+			return;
+		}
+		
+		Node *node = new Node();
+		node->commands = aBatch.mCommands;
+		aBatch.clear();
+		
+		// Treiber stack push; the consumer takes the whole stack at once, so there is no ABA problem
+		Node *head;
+		do
+		{
+			head = mHead;
+			node->next = head;
+		} while (!mHead.testAndSetRelease(head, node));
+	}
+	
+	void UiCommandQueue::post(QObject *aTarget, const char *aProperty, const QVariant &aValue)
+	{
+		UiCommandBatch batch;
+		batch.setProperty(aTarget, aProperty, aValue);
+		post(batch);
+	}
+	
+	int UiCommandQueue::apply()
+	{
+		Node *node = mHead.fetchAndStoreAcquire(NULL);
+		if (!node)
+		{
+			return 0;
+		}
+		
+		// walk from the newest batch to the oldest and keep the first change seen per property
+		QSet<UiCommandBatch::PropertyKey> seen;
+		QVector<const UiCommandBatch::Command *> latest;
+		QVector<Node *> nodes;
+		
+		for (; node; node = node->next)
+		{
+			nodes.append(node);
+			
+			for (int i = node->commands.size() - 1; i >= 0; --i)
+			{
+				const UiCommandBatch::Command &command = node->commands.at(i);
+				const UiCommandBatch::PropertyKey key(command.target, command.property);
+				
+				if (!seen.contains(key))
+				{
+					seen.insert(key);
+					latest.append(&command);
+				}
+			}
+		}
+		
+		// apply in posting order
+		for (int i = latest.size() - 1; i >= 0; --i)
+		{
+			const UiCommandBatch::Command *command = latest.at(i);
+			if (!command->target->setProperty(command->property.constData(), command->value))
+			{
+				qWarning() << "UiCommandQueue: cannot set property" << command->property << "of"
+						<< command->target;
+			}
+		}
+		
+		qDeleteAll(nodes);
+		return latest.size();
+	}
+	
+	bool UiCommandQueue::isEmpty() const
+	{
+		return (mHead == NULL);
+	}
+}
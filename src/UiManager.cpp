@@ -26,46 +26,205 @@
 #include "UiManager.h"
 #include "InputManager.h"
 #include "Constants.h"
+#include "FrameAnimationDriver.h"
+#include "RemoteUiClient.h"
 #include "TextureMath.h"
 #include "Exception.h"
+#include "TileDiff.h"
+#include "PixelConversion.h"
+#include "CachedProxyWidget.h"
 
 using namespace Cutexture::Utility;
 
-namespace Cutexture
+namespace
 {
+	/** An item to paint in bands, with all state that would 
+	 * otherwise have to be queried from the scene. */
+	struct ItemPaintJob
+	{
+		QGraphicsItem *item;
+		
+		/** Item to view transformation and its inverse. */
+		QTransform transform;
+		QTransform inverseTransform;
+		
+		QRectF boundingRect;
+		
+		qreal opacity;
+		bool selected;
+		
+		/** Bounding rectangle of the item in view coordinates. */
+		QRect viewBounds;
+	};
+	
+	/** Consecutive items in stacking order which are either all 
+	 * painted on worker threads or all on the GUI thread. */
+	struct PaintSegment
+	{
+		bool threadSafe;
+		QVector<ItemPaintJob> jobs;
+	};
+	
+	/** A horizontal band of the target image. */
+	struct RenderBand
+	{
+		/** First scanline of the band in the target image. */
+		uchar *bits;
+		
+		int top;
+		int width;
+		int height;
+		int bytesPerLine;
+		QImage::Format format;
+		
+		QPainter::RenderHints renderHints;
+	};
+	
+	/** @return The cache mode named by aValue of the cache mode 
+	 * property. */
+	Cutexture::Enums::WidgetCacheMode toWidgetCacheMode(const QString &aValue)
+	{
+		if (aValue.compare("pixmap", Qt::CaseInsensitive) == 0)
+		{
+			return Cutexture::Enums::WidgetCachePixmap;
+		}
+		else if (aValue.compare("picture", Qt::CaseInsensitive) == 0)
+		{
+			return Cutexture::Enums::WidgetCachePicture;
+		}
+		
+		return Cutexture::Enums::WidgetCacheNone;
+	}
 	
-	UiManager::UiManager() :
-		mWidgetScene(NULL), mWidgetView(NULL), mTopLevelWidget(NULL),
-				mFocusedWidget(NULL), mUiDirty(false),
-				mInputManager(NULL)
+	/** Paints the part of aJobs inside aBand. Runs on a worker 
+	 * thread for thread-safe segments and on the GUI thread for 
+	 * the others. */
+	void paintBand(const RenderBand &aBand, const QVector<ItemPaintJob> *aJobs)
 	{
-		mWidgetScene = new QGraphicsScene(this);
-		mWidgetView = new QGraphicsView(mWidgetScene);
-		mWidgetView->setAlignment(Qt::AlignLeft | Qt::AlignTop);
+		// wraps the band's scanlines of the target image without copying
+		QImage bandImage(aBand.bits, aBand.width, aBand.height, aBand.bytesPerLine, aBand.format);
 		
-		// for debugging, show Qt's window with
-		// mWidgetView->show();
+		const QRect bandRect(0, aBand.top, aBand.width, aBand.height);
+		const QTransform bandOffset = QTransform::fromTranslate(0, -aBand.top);
+		
+		QPainter painter(&bandImage);
+		painter.setRenderHints(aBand.renderHints);
+		
+		for (int i = 0; i < aJobs->size(); ++i)
+		{
+			const ItemPaintJob &job = aJobs->at(i);
+			
+			if (!job.viewBounds.intersects(bandRect))
+			{
+				continue;
+			}
+			
+			// only the part in this band, e.g. a proxy widget renders just that
+			QStyleOptionGraphicsItem option;
+			option.exposedRect = job.inverseTransform.mapRect(QRectF(bandRect)) & job.boundingRect;
+			option.rect = job.boundingRect.toAlignedRect();
+			option.state = job.selected ? QStyle::State_Selected : QStyle::State_None;
+			
+			painter.save();
+			painter.setTransform(job.transform * bandOffset);
+			painter.setOpacity(job.opacity);
+			job.item->paint(&painter, &option, NULL);
+			painter.restore();
+		}
+	}
+}
 
-		// We need to manually tell the scene that a visible view is watching.
-		// A QGraphicsView doesn't do that when it is not visible as 
-		// a widget on screen.
-		QEvent wsce(QEvent::WindowActivate);
-		QApplication::sendEvent(mWidgetScene, &wsce);
+namespace Cutexture
+{
+	
+	UiManager::UiManager(Enums::UiBackend aBackend) :
+		mBackend(aBackend), mRemoteUi(NULL), mWidgetScene(NULL), mWidgetView(NULL), mTopLevelWidget(NULL),
+				mFocusedWidget(NULL), mMouseGrabber(NULL), mHoveredWidget(NULL), mUiDirty(false),
+				mInputManager(NULL), mHibernating(false), mTileDiff(NULL),
+				mTexturePaddingDirty(true), mLastUploadedPixels(0), mTextureFormat(Enums::TextureFormatARGB8888),
+				mTintColour(Qt::white), mStaticUi(false), mStaticEncodeTimer(NULL),
+				mEncodeWatcher(NULL), mContentGeneration(0), mEncodeGeneration(0),
+				mCompressedTextureShown(false), mRenderScale(1), mParallelRendering(false),
+				mLastRenderBandCount(1), mPrewarmedWidgets(0), mPrewarmedCharacters(0), mPrewarmTime(0),
+				mLateLatchSceneManager(NULL), mAnimationDriver(NULL),
+				mMaxRepaintRate(0), mFrameTime(0), mLastRepaintTime(-1)
+	{
+		if (mBackend == Enums::UiBackendGraphicsView)
+		{
+			mWidgetScene = new QGraphicsScene(this);
+			mWidgetView = new QGraphicsView(mWidgetScene);
+			mWidgetView->setAlignment(Qt::AlignLeft | Qt::AlignTop);
+			
+			// for debugging, show Qt's window with
+			// mWidgetView->show();
+	
+			// We need to manually tell the scene that a visible view is watching.
+			// A QGraphicsView doesn't do that when it is not visible as 
+			// a widget on screen.
+			QEvent wsce(QEvent::WindowActivate);
+			QApplication::sendEvent(mWidgetScene, &wsce);
+			
+			connect(mWidgetScene, SIGNAL(changed(const QList<QRectF> &)), this, SLOT(setUiDirty()));
+		}
+		else if (mBackend == Enums::UiBackendRemoteProcess)
+		{
+			mRemoteUi = new RemoteUiClient(this);
+			connect(mRemoteUi, SIGNAL(frameReady()), this, SLOT(setUiDirty()));
+			
+			// the overlay bounds change when the helper is gone
+			connect(mRemoteUi, SIGNAL(disconnected()), this, SLOT(setUiDirty()));
+		}
+		
+		mStaticEncodeTimer = new QTimer(this);
+		mStaticEncodeTimer->setSingleShot(true);
+		mStaticEncodeTimer->setInterval(Constants::UI_STATIC_ENCODE_DELAY);
+		connect(mStaticEncodeTimer, SIGNAL(timeout()), this, SLOT(encodeStaticUi()));
 		
-		connect(mWidgetScene, SIGNAL(changed(const QList<QRectF> &)), this, SLOT(setUiDirty()));
+		mEncodeWatcher = new QFutureWatcher<Utility::CompressedImage>(this);
+		connect(mEncodeWatcher, SIGNAL(finished()), this, SLOT(staticUiEncoded()));
 	}
 
 	UiManager::~UiManager()
 	{
-		QEvent wsce(QEvent::WindowDeactivate);
-		QApplication::sendEvent(mWidgetScene, &wsce);
+		if (mWidgetScene)
+		{
+			QEvent wsce(QEvent::WindowDeactivate);
+			QApplication::sendEvent(mWidgetScene, &wsce);
+		}
+		else
+		{
+			// the scene owns the widget with the graphics view backend
+			delete mTopLevelWidget;
+		}
+		
+		// the scene only owns widgets which were embedded
+		foreach(QWidget *widget, mRetainedWidgets)
+		{
+			if (widget != mTopLevelWidget && !widget->graphicsProxyWidget())
+			{
+				delete widget;
+			}
+		}
+		
+		setLateLatching(NULL, Ogre::TexturePtr());
+		setFrameClock(false);
+		
+		// the worker only reads its own copy of the image, but its result is of no use anymore
+		mEncodeWatcher->waitForFinished();
+		
+		delete mTileDiff;
 		
 		// Note: For ~QGraphicsScene to be able to run, qApp must still be valid.
 	}
 	
 	void UiManager::setActiveWidget(QWidget *aWidget)
 	{
-		assert(mWidgetScene);
+		assert(aWidget);
+		
+		if (mRemoteUi)
+		{
+			EXCEPTION("The widgets of a remote UI live in the helper process.", "UiManager::setActiveWidget()");
+		}
 		
 		if (mTopLevelWidget && mTopLevelWidget != aWidget)
 		{
@@ -75,13 +234,169 @@ namespace Cutexture
 				QApplication::sendEvent(mFocusedWidget, &foe);
 				mFocusedWidget = NULL;
 			}
+			
+			mMouseGrabber = NULL;
+			mHoveredWidget = NULL;
 
-			mWidgetScene->clear();
+			if (mWidgetScene)
+			{
+				QGraphicsProxyWidget *proxy = mTopLevelWidget->graphicsProxyWidget();
+				
+				// retained widgets stay embedded, so that showing them again is cheap
+				if (mRetainedWidgets.contains(mTopLevelWidget))
+				{
+					proxy->hide();
+				}
+				else
+				{
+					// deletes the widget as well
+					delete proxy;
+				}
+			}
+			else
+			{
+				mTopLevelWidget->removeEventFilter(this);
+				
+				if (mRetainedWidgets.contains(mTopLevelWidget))
+				{
+					mTopLevelWidget->hide();
+				}
+				else
+				{
+					mTopLevelWidget->deleteLater();
+				}
+			}
 			mTopLevelWidget = NULL;
+			mDataBinder.setRoot(NULL);
+		}
+		
+		if (mBackend == Enums::UiBackendDirectWidget)
+		{
+			mTopLevelWidget = aWidget;
+			mDataBinder.setRoot(aWidget);
+			
+			if (!mWindowSize.isEmpty())
+			{
+				aWidget->resize(getLayoutSize(mWindowSize));
+			}
+			
+			// visible for Qt, so that it is laid out and painted, but never shown on screen
+			aWidget->setAttribute(Qt::WA_DontShowOnScreen);
+			aWidget->installEventFilter(this);
+			aWidget->show();
+			
+			QEvent wae(QEvent::WindowActivate);
+			QApplication::sendEvent(aWidget, &wae);
+			
+			setUiDirty(true);
+			return;
 		}
 	
-		mWidgetScene->addWidget(aWidget);
+		// a retained widget which was active before is still embedded
+		if (aWidget->graphicsProxyWidget())
+		{
+			mTopLevelWidget = aWidget;
+			mDataBinder.setRoot(aWidget);
+			
+			if (!mWindowSize.isEmpty())
+			{
+				aWidget->resize(getLayoutSize(mWindowSize));
+			}
+			
+			aWidget->graphicsProxyWidget()->show();
+			setUiDirty(true);
+			return;
+		}
+		
+		// same as QGraphicsScene::addWidget(), but with a proxy which supports cache modes
+		CachedProxyWidget *proxy = new CachedProxyWidget();
+		proxy->setWidget(aWidget);
+		mWidgetScene->addItem(proxy);
 		mTopLevelWidget = aWidget;
+		mDataBinder.setRoot(aWidget);
+		
+		QList<QWidget *> widgets = aWidget->findChildren<QWidget *> ();
+		widgets.prepend(aWidget);
+		
+		foreach(QWidget *widget, widgets)
+		{
+			const QVariant cacheMode = widget->property(Constants::UI_CACHE_MODE_PROPERTY);
+			if (cacheMode.isValid() && !widget->isWindow())
+			{
+				setWidgetCacheMode(widget, toWidgetCacheMode(cacheMode.toString()));
+			}
+		}
+	}
+	
+	void UiManager::retainWidget(QWidget *aWidget)
+	{
+		assert(aWidget && !mRemoteUi);
+		
+		mRetainedWidgets.insert(aWidget);
+	}
+	
+	void UiManager::releaseWidget(QWidget *aWidget)
+	{
+		if (!mRetainedWidgets.remove(aWidget) || aWidget == mTopLevelWidget)
+		{
+			return;
+		}
+		
+		if (aWidget->graphicsProxyWidget())
+		{
+			delete aWidget->graphicsProxyWidget();
+		}
+		else
+		{
+			delete aWidget;
+		}
+	}
+	
+	void UiManager::setWidgetCacheMode(QWidget *aWidget, Enums::WidgetCacheMode aMode)
+	{
+		// only the graphics view backend has proxies
+		if (mBackend != Enums::UiBackendGraphicsView)
+		{
+			return;
+		}
+		
+		CachedProxyWidget *proxy = getProxy(aWidget, true);
+		
+		if (!proxy)
+		{
+			EXCEPTION("Widget is not part of the active UI.", "UiManager::setWidgetCacheMode()");
+		}
+		
+		proxy->setWidgetCacheMode(aMode);
+	}
+	
+	void UiManager::invalidateWidgetCache(QWidget *aWidget)
+	{
+		CachedProxyWidget *proxy = getProxy(aWidget, false);
+		
+		if (proxy)
+		{
+			proxy->invalidateCache();
+		}
+	}
+	
+	CachedProxyWidget* UiManager::getProxy(QWidget *aWidget, bool aCreate) const
+	{
+		assert(aWidget);
+		
+		if (!mWidgetScene || !mTopLevelWidget || (aWidget != mTopLevelWidget && !mTopLevelWidget->isAncestorOf(aWidget)))
+		{
+			return NULL;
+		}
+		
+		// all proxies in the scene are created by setActiveWidget() or CachedProxyWidget
+		QGraphicsProxyWidget *proxy = aWidget->graphicsProxyWidget();
+		if (!proxy && aCreate)
+		{
+			proxy = mTopLevelWidget->graphicsProxyWidget()->createProxyForChildWidget(aWidget);
+		}
+		
+		return static_cast<CachedProxyWidget *> (proxy);
 	}
 	
 	void UiManager::setInputManager(InputManager *aInputManager)
@@ -114,44 +429,136 @@ namespace Cutexture
 		assert(!aMaterial.isNull());
 		assert(!aTexture.isNull());
 		
+		mWindowSize = aSize;
+		const QSize renderSize = getRenderSize(aSize);
+		
 		// get the smallest power of two dimension that is at least as large as the new UI size
-		Ogre::uint newTexWidth = nextHigherPowerOfTwo(aSize.width());
-		Ogre::uint newTexHeight = nextHigherPowerOfTwo(aSize.height());
+		Ogre::uint newTexWidth = nextHigherPowerOfTwo(renderSize.width());
+		Ogre::uint newTexHeight = nextHigherPowerOfTwo(renderSize.height());
 	
 		if (!aTexture.isNull())
 		{
 			std::string txtrName = aTexture->getName();
 			
+			// the compressed texture has the old size
+			removeCompressedTexture();
+			mMaterial = aMaterial;
+			mTextureName = txtrName;
+			
 			// remove the old texture
 			aTexture->unload();
 			aMaterial->getTechnique(0)->getPass(0)->removeAllTextureUnitStates();
 			Ogre::TextureManager::getSingleton().remove(aTexture->getHandle());
 	
 			Ogre::TexturePtr newTxtr = Ogre::TextureManager::getSingleton().createManual(
-					txtrName, "General", Ogre::TEX_TYPE_2D, newTexWidth, newTexHeight, 0, Ogre::PF_A8R8G8B8,
-					Ogre::TU_DYNAMIC_WRITE_ONLY);
+					txtrName, "General", Ogre::TEX_TYPE_2D, newTexWidth, newTexHeight, 0,
+					toOgrePixelFormat(mTextureFormat), Ogre::TU_DYNAMIC_WRITE_ONLY);
 	
 			// add the new texture
 			Ogre::TextureUnitState* txtrUstate = aMaterial->getTechnique(0)->getPass(0)->createTextureUnitState(txtrName);
+			
+			// an alpha-only texture takes its colour from the tint colour
+			if (mTextureFormat == Enums::TextureFormatAlpha8)
+			{
+				txtrUstate->setColourOperationEx(Ogre::LBX_SOURCE1, Ogre::LBS_MANUAL, Ogre::LBS_CURRENT,
+						Ogre::ColourValue(mTintColour.redF(), mTintColour.greenF(), mTintColour.blueF()));
+			}
 	
-			// adjust it to stay aligned and scaled to the window
-			Ogre::Real txtrUScale = (Ogre::Real)newTexWidth / aSize.width();
-			Ogre::Real txtrVScale = (Ogre::Real)newTexHeight / aSize.height();
+			// adjust it to stay aligned and scaled to the window; this also upscales a reduced render size
+			Ogre::Real txtrUScale = (Ogre::Real)newTexWidth / renderSize.width();
+			Ogre::Real txtrVScale = (Ogre::Real)newTexHeight / renderSize.height();
 			txtrUstate->setTextureScale(txtrUScale, txtrVScale);
 			txtrUstate->setTextureScroll((1 / txtrUScale) / 2 - 0.5, (1 / txtrVScale) / 2 - 0.5);
+			
+			// the new texture has undefined contents
+			if (mTileDiff)
+			{
+				mTileDiff->reset();
+			}
+			mTexturePaddingDirty = true;
 		}
 	}
 	
+	bool UiManager::startRemoteUi(const QString &aProgram, const QStringList &aArguments)
+	{
+		assert(mRemoteUi);
+		
+		if (!mWindowSize.isEmpty())
+		{
+			mRemoteUi->resize(mWindowSize);
+		}
+		
+		return mRemoteUi->start(aProgram, aArguments);
+	}
+	
+	bool UiManager::isRemoteUiConnected() const
+	{
+		return (mRemoteUi && mRemoteUi->isConnected());
+	}
+	
 	void UiManager::resizeUi(QResizeEvent *aEvent)
 	{
+		mWindowSize = aEvent->size();
+		
+		if (mRemoteUi)
+		{
+			mRemoteUi->resize(mWindowSize);
+			return;
+		}
+		
 		if (mTopLevelWidget)
 		{
-			mTopLevelWidget->resize(aEvent->size());
+			mTopLevelWidget->resize(getLayoutSize(aEvent->size()));
 		}
 	}
 	
-	void UiManager::mousePressEvent(QMouseEvent *event)
+	void UiManager::mousePressEvent(QMouseEvent *aWindowEvent)
 	{
+		mMousePosition = aWindowEvent->pos();
+		
+		if (mRemoteUi)
+		{
+			mRemoteUi->sendMouseEvent(aWindowEvent);
+			return;
+		}
+		
+		if (mBackend == Enums::UiBackendDirectWidget)
+		{
+			if (!mTopLevelWidget)
+			{
+				return;
+			}
+			
+			const QPoint pos = mapToLayout(aWindowEvent->pos());
+			QWidget *target = widgetAt(pos);
+			
+			// same focus handling as with the graphics view backend
+			QWidget *pressedWidget = (target != mTopLevelWidget || mTopLevelWidget->children().isEmpty()) ? target : NULL;
+			
+			if (mFocusedWidget && pressedWidget != mFocusedWidget)
+			{
+				QEvent foe(QEvent::FocusOut);
+				QApplication::sendEvent(mFocusedWidget, &foe);
+				mFocusedWidget = NULL;
+				mTopLevelWidget->setFocus();
+			}
+			
+			if (pressedWidget)
+			{
+				QEvent fie(QEvent::FocusIn);
+				QApplication::sendEvent(pressedWidget, &fie);
+				pressedWidget->setFocus(Qt::MouseFocusReason);
+				mFocusedWidget = pressedWidget;
+			}
+			
+			mMouseGrabber = target;
+			sendMouseEvent(target, aWindowEvent, pos);
+			return;
+		}
+		
+		QMouseEvent viewEvent = mapFromWindow(aWindowEvent);
+		QMouseEvent *event = &viewEvent;
+		
 		QWidget *pressedWidget = NULL;
 	
 		// get the clicked item through the view (respects view and item transformations)
@@ -199,62 +606,1108 @@ namespace Cutexture
 	
 	void UiManager::mouseReleaseEvent(QMouseEvent *event)
 	{
-		QApplication::sendEvent(mWidgetView->viewport(), event);
+		mMousePosition = event->pos();
+		
+		if (mRemoteUi)
+		{
+			mRemoteUi->sendMouseEvent(event);
+			return;
+		}
+		
+		if (mBackend == Enums::UiBackendDirectWidget)
+		{
+			if (mTopLevelWidget)
+			{
+				const QPoint pos = mapToLayout(event->pos());
+				sendMouseEvent(mMouseGrabber ? mMouseGrabber : widgetAt(pos), event, pos);
+				
+				if (event->buttons() == Qt::NoButton)
+				{
+					mMouseGrabber = NULL;
+				}
+			}
+			return;
+		}
+		
+		QMouseEvent viewEvent = mapFromWindow(event);
+		QApplication::sendEvent(mWidgetView->viewport(), &viewEvent);
 	}
 	
 	void UiManager::mouseMoveEvent(QMouseEvent *event)
 	{
-		QApplication::sendEvent(mWidgetView->viewport(), event);
+		mMousePosition = event->pos();
+		
+		if (mRemoteUi)
+		{
+			mRemoteUi->sendMouseEvent(event);
+			return;
+		}
+		
+		if (mBackend == Enums::UiBackendDirectWidget)
+		{
+			if (mTopLevelWidget)
+			{
+				const QPoint pos = mapToLayout(event->pos());
+				QWidget *widgetUnderMouse = widgetAt(pos);
+				updateHoveredWidget(widgetUnderMouse);
+				sendMouseEvent(mMouseGrabber ? mMouseGrabber : widgetUnderMouse, event, pos);
+			}
+			return;
+		}
+		
+		QMouseEvent viewEvent = mapFromWindow(event);
+		QApplication::sendEvent(mWidgetView->viewport(), &viewEvent);
 	}
 	
 	void UiManager::keyPressEvent(QKeyEvent *event)
 	{
+		if (mRemoteUi)
+		{
+			mRemoteUi->sendKeyEvent(event);
+			return;
+		}
+		
+		if (mBackend == Enums::UiBackendDirectWidget)
+		{
+			if (mTopLevelWidget)
+			{
+				QWidget *target = mFocusedWidget ? mFocusedWidget : mTopLevelWidget;
+				QApplication::sendEvent(target, event);
+			}
+			return;
+		}
+		
 		QApplication::sendEvent(mWidgetView->viewport(), event);
 	}
 	
 	void UiManager::keyReleaseEvent(QKeyEvent *event)
 	{
+		if (mRemoteUi)
+		{
+			mRemoteUi->sendKeyEvent(event);
+			return;
+		}
+		
+		if (mBackend == Enums::UiBackendDirectWidget)
+		{
+			if (mTopLevelWidget)
+			{
+				QWidget *target = mFocusedWidget ? mFocusedWidget : mTopLevelWidget;
+				QApplication::sendEvent(target, event);
+			}
+			return;
+		}
+		
 		QApplication::sendEvent(mWidgetView->viewport(), event);
 	}
 	
-	void UiManager::setUiDirty(bool aDirty)
-	{
-		mUiDirty = aDirty;
-	}
-	
-	bool UiManager::isViewSizeMatching(const Ogre::TexturePtr &aTexture) const
+	bool UiManager::eventFilter(QObject *aObject, QEvent *aEvent)
 	{
-		assert(!aTexture.isNull());
+		// Qt still has to process the request, it syncs the backing store of the widget
+		if (aObject == mTopLevelWidget && aEvent->type() == QEvent::UpdateRequest)
+		{
+			setUiDirty(true);
+		}
 		
-		return (aTexture->getWidth() == mWidgetView->width() && aTexture->getHeight() == mWidgetView->height());
+		return QObject::eventFilter(aObject, aEvent);
 	}
 	
-	void UiManager::setViewSize(const Ogre::TexturePtr &aTexture)
+	QPoint UiManager::mapToLayout(const QPoint &aPoint) const
 	{
-		// make sure that the view size matches the texture size
-		if (!aTexture.isNull() && !isViewSizeMatching(aTexture))
+		const QSize layoutSize = getLayoutSize(mWindowSize);
+		if (layoutSize == mWindowSize || mWindowSize.isEmpty())
 		{
-			mWidgetView->setGeometry(QRect(0, 0, aTexture->getWidth(), aTexture->getHeight()));
+			return aPoint;
 		}
+		
+		return QPoint(aPoint.x() * layoutSize.width() / mWindowSize.width(), aPoint.y()
+				* layoutSize.height() / mWindowSize.height());
 	}
 	
-	void UiManager::renderIntoTexture(const Ogre::TexturePtr &aTexture)
+	QWidget* UiManager::widgetAt(const QPoint &aPos) const
 	{
-		assert(!aTexture.isNull());
-		assert(isViewSizeMatching(aTexture));
-		
-		Ogre::HardwarePixelBufferSharedPtr hwBuffer = aTexture->getBuffer(0, 0);
-		hwBuffer->lock(Ogre::HardwareBuffer::HBL_DISCARD);
+		assert(mTopLevelWidget);
 		
-		const Ogre::PixelBox &pb = hwBuffer->getCurrentLock();
+		QWidget *child = mTopLevelWidget->childAt(aPos);
+		return child ? child : mTopLevelWidget;
+	}
+	
+	void UiManager::sendMouseEvent(QWidget *aTarget, const QMouseEvent *aEvent, const QPoint &aPos)
+	{
+		// the global position is the position in the active widget; it is never shown on screen
+		QMouseEvent targetEvent(aEvent->type(), aTarget->mapFrom(mTopLevelWidget, aPos), aPos,
+				aEvent->button(), aEvent->buttons(), aEvent->modifiers());
+		QApplication::sendEvent(aTarget, &targetEvent);
+	}
+	
+	void UiManager::updateHoveredWidget(QWidget *aWidget)
+	{
+		if (aWidget == mHoveredWidget)
+		{
+			return;
+		}
 		
-		// render into texture buffer
-		QImage textureImg((uchar *)pb.data, pb.getWidth(), pb.getHeight(), QImage::Format_ARGB32);
-		textureImg.fill(0);
+		// styles draw hover effects based on Qt::WA_UnderMouse
+		if (mHoveredWidget)
+		{
+			mHoveredWidget->setAttribute(Qt::WA_UnderMouse, false);
+			QEvent leaveEvent(QEvent::Leave);
+			QApplication::sendEvent(mHoveredWidget, &leaveEvent);
+		}
 		
-		QPainter painter(&textureImg);
-		mWidgetView->render(&painter, QRect(QPoint(0, 0), mWidgetView->size()), QRect(QPoint(0, 0), mWidgetView->size()));
+		mHoveredWidget = aWidget;
 		
-		hwBuffer->unlock();
+		if (mHoveredWidget)
+		{
+			mHoveredWidget->setAttribute(Qt::WA_UnderMouse, true);
+			QEvent enterEvent(QEvent::Enter);
+			QApplication::sendEvent(mHoveredWidget, &enterEvent);
+		}
+	}
+	
+	void UiManager::setUiDirty(bool aDirty)
+	{
+		mUiDirty = aDirty;
+	}
+	
+	QRect UiManager::getContentBounds() const
+	{
+		if (mRemoteUi)
+		{
+			return mRemoteUi->getContentBounds();
+		}
+		
+		if (mBackend == Enums::UiBackendDirectWidget)
+		{
+			if (!mTopLevelWidget)
+			{
+				return QRect();
+			}
+			
+			QRect layoutBounds;
+			if (mTopLevelWidget->testAttribute(Qt::WA_TranslucentBackground))
+			{
+				// a translucent top-level widget only shows its children
+				foreach(QObject *child, mTopLevelWidget->children())
+				{
+					QWidget *childWidget = qobject_cast<QWidget *>(child);
+					if (childWidget && childWidget->isVisible() && !childWidget->isWindow())
+					{
+						layoutBounds |= childWidget->geometry();
+					}
+				}
+			}
+			else
+			{
+				layoutBounds = mTopLevelWidget->rect();
+			}
+			
+			const QSize layoutSize = getLayoutSize(mWindowSize);
+			if (layoutBounds.isEmpty() || layoutSize == mWindowSize || mWindowSize.isEmpty())
+			{
+				return layoutBounds;
+			}
+			
+			const qreal scaleX = qreal(mWindowSize.width()) / layoutSize.width();
+			const qreal scaleY = qreal(mWindowSize.height()) / layoutSize.height();
+			return QRectF(layoutBounds.left() * scaleX, layoutBounds.top() * scaleY,
+					layoutBounds.width() * scaleX, layoutBounds.height() * scaleY).toAlignedRect();
+		}
+		
+		QRectF sceneBounds;
+		
+		foreach(QGraphicsItem *item, mWidgetScene->items())
+		{
+			// child items are contained in their parent's bounding rectangle
+			if (item->parentItem() || !item->isVisible())
+			{
+				continue;
+			}
+			
+			QGraphicsProxyWidget *proxyWidget = qgraphicsitem_cast<QGraphicsProxyWidget *>(item);
+			if (proxyWidget && proxyWidget->widget() == mTopLevelWidget
+					&& mTopLevelWidget->testAttribute(Qt::WA_TranslucentBackground))
+			{
+				// a translucent top-level widget only shows its children
+				foreach(QObject *child, mTopLevelWidget->children())
+				{
+					QWidget *childWidget = qobject_cast<QWidget *>(child);
+					if (childWidget && childWidget->isVisible() && !childWidget->isWindow())
+					{
+						sceneBounds |= proxyWidget->mapRectToScene(QRectF(childWidget->geometry()));
+					}
+				}
+			}
+			else
+			{
+				sceneBounds |= item->sceneBoundingRect();
+			}
+		}
+		
+		if (sceneBounds.isEmpty())
+		{
+			return QRect();
+		}
+		
+		const QRect viewBounds = mWidgetView->mapFromScene(sceneBounds).boundingRect()
+				& mWidgetView->viewport()->rect();
+		
+		// map to window coordinates; the overlay stretches the render size to the window
+		const QSize renderSize = getRenderSize(mWindowSize);
+		if (viewBounds.isEmpty() || renderSize == mWindowSize || renderSize.isEmpty())
+		{
+			return viewBounds;
+		}
+		
+		const qreal scaleX = qreal(mWindowSize.width()) / renderSize.width();
+		const qreal scaleY = qreal(mWindowSize.height()) / renderSize.height();
+		return QRectF(viewBounds.left() * scaleX, viewBounds.top() * scaleY, viewBounds.width()
+				* scaleX, viewBounds.height() * scaleY).toAlignedRect();
+	}
+	
+	QCursor UiManager::getCursor() const
+	{
+		if (mRemoteUi)
+		{
+			return QCursor(mRemoteUi->getCursorShape());
+		}
+		
+		QWidget *widget = NULL;
+		
+		if (mBackend == Enums::UiBackendDirectWidget)
+		{
+			if (mTopLevelWidget)
+			{
+				widget = mMouseGrabber ? mMouseGrabber : widgetAt(mapToLayout(mMousePosition));
+			}
+		}
+		else if (mWidgetView)
+		{
+			const QPoint viewPos = mapFromWindow(mMousePosition);
+			QGraphicsProxyWidget *proxy = qgraphicsitem_cast<QGraphicsProxyWidget *>(
+					mWidgetView->itemAt(viewPos));
+			
+			if (proxy && proxy->widget())
+			{
+				const QPoint widgetPos = proxy->mapFromScene(mWidgetView->mapToScene(viewPos)).toPoint();
+				widget = proxy->widget()->childAt(widgetPos);
+				if (!widget)
+				{
+					widget = proxy->widget();
+				}
+			}
+		}
+		
+		// QWidget::cursor() falls back to the cursor of the parent
+		return widget ? widget->cursor() : QCursor(Qt::ArrowCursor);
+	}
+	
+	void UiManager::setVirtualResolution(const QSize &aResolution)
+	{
+		mVirtualResolution = aResolution;
+	}
+	
+	void UiManager::setRenderScale(qreal aScale)
+	{
+		assert(aScale > 0);
+		
+		mRenderScale = aScale;
+	}
+	
+	QSize UiManager::getLayoutSize(const QSize &aWindowSize) const
+	{
+		return mVirtualResolution.isEmpty() ? aWindowSize : mVirtualResolution;
+	}
+	
+	QSize UiManager::getRenderSize(const QSize &aWindowSize) const
+	{
+		const QSize layoutSize = getLayoutSize(aWindowSize);
+		return QSize(qMax(1, qRound(layoutSize.width() * mRenderScale)), qMax(1, qRound(
+				layoutSize.height() * mRenderScale)));
+	}
+	
+	QPoint UiManager::mapFromWindow(const QPoint &aPoint) const
+	{
+		const QSize renderSize = getRenderSize(mWindowSize);
+		if (renderSize == mWindowSize || mWindowSize.isEmpty())
+		{
+			return aPoint;
+		}
+		
+		return QPoint(aPoint.x() * renderSize.width() / mWindowSize.width(), aPoint.y()
+				* renderSize.height() / mWindowSize.height());
+	}
+	
+	QMouseEvent UiManager::mapFromWindow(const QMouseEvent *aEvent) const
+	{
+		const QPoint viewPos = mapFromWindow(aEvent->pos());
+		return QMouseEvent(aEvent->type(), viewPos, aEvent->globalPos(), aEvent->button(),
+				aEvent->buttons(), aEvent->modifiers());
+	}
+	
+	void UiManager::hibernate(const Ogre::TexturePtr &aTexture, bool aReleaseResources)
+	{
+		assert(!aTexture.isNull());
+		
+		if (mHibernating)
+		{
+			return;
+		}
+		
+		if (aReleaseResources)
+		{
+			// the texture stays registered with Ogre; only its hardware buffers are freed
+			aTexture->freeInternalResources();
+			QPixmapCache::clear();
+			removeCompressedTexture();
+			
+			// the recreated texture has to be uploaded completely
+			mTextureImage = QImage();
+			if (mTileDiff)
+			{
+				mTileDiff->reset();
+			}
+			mTexturePaddingDirty = true;
+		}
+		
+		mHibernating = true;
+	}
+	
+	void UiManager::resume(const Ogre::TexturePtr &aTexture)
+	{
+		assert(!aTexture.isNull());
+		
+		if (!mHibernating)
+		{
+			return;
+		}
+		
+		// no-op if the resources were not released
+		aTexture->createInternalResources();
+		
+		mHibernating = false;
+		setUiDirty(true);
+	}
+	
+	bool UiManager::isViewSizeMatching(const Ogre::TexturePtr &aTexture) const
+	{
+		assert(!aTexture.isNull());
+		
+		// the directly rendered widget is independent of the texture size
+		if (!mWidgetView)
+		{
+			return true;
+		}
+		
+		return (aTexture->getWidth() == mWidgetView->width() && aTexture->getHeight() == mWidgetView->height());
+	}
+	
+	void UiManager::setViewSize(const Ogre::TexturePtr &aTexture)
+	{
+		if (!aTexture.isNull())
+		{
+			setViewSize(QSize(aTexture->getWidth(), aTexture->getHeight()));
+		}
+	}
+	
+	void UiManager::setViewSize(const QSize &aSize)
+	{
+		if (!mWidgetView)
+		{
+			return;
+		}
+		
+		// make sure that the view size matches the texture size
+		if (mWidgetView->size() != aSize)
+		{
+			mWidgetView->setGeometry(QRect(QPoint(0, 0), aSize));
+		}
+		
+		// scale the laid out UI to the part of the texture shown by the overlay
+		const QSize layoutSize = getLayoutSize(mWindowSize);
+		const QSize renderSize = getRenderSize(mWindowSize);
+		if (!layoutSize.isEmpty())
+		{
+			mWidgetView->setTransform(QTransform::fromScale(qreal(renderSize.width())
+					/ layoutSize.width(), qreal(renderSize.height()) / layoutSize.height()));
+		}
+	}
+	
+	void UiManager::renderIntoTexture(const Ogre::TexturePtr &aTexture)
+	{
+		assert(!aTexture.isNull());
+		assert(isViewSizeMatching(aTexture));
+		
+		showUncompressedTexture(aTexture);
+		
+		mLastRepaintTime = mFrameTime;
+		
+		// the helper process has already rendered the UI
+		if (mRemoteUi)
+		{
+			mLastUploadedPixels = mRemoteUi->uploadFrame(aTexture, mTextureFormat);
+			return;
+		}
+		
+		++mContentGeneration;
+		if (mStaticUi)
+		{
+			mStaticEncodeTimer->start();
+		}
+		
+		if (mTileDiff)
+		{
+			renderChangedTiles(aTexture);
+			return;
+		}
+		
+		Ogre::HardwarePixelBufferSharedPtr hwBuffer = aTexture->getBuffer(0, 0);
+		hwBuffer->lock(Ogre::HardwareBuffer::HBL_DISCARD);
+		
+		const Ogre::PixelBox &pb = hwBuffer->getCurrentLock();
+		
+		// a static UI keeps a system memory copy for encoding
+		if (mTextureFormat == Enums::TextureFormatARGB8888 && !mStaticUi)
+		{
+			// render into texture buffer
+			QImage textureImg((uchar *)pb.data, pb.getWidth(), pb.getHeight(), QImage::Format_ARGB32);
+			rasterize(textureImg);
+		}
+		else
+		{
+			// render into system memory and convert into the texture buffer
+			prepareTextureImage(QSize(pb.getWidth(), pb.getHeight()));
+			rasterize(mTextureImage);
+			convertPixels(mTextureImage, mTextureImage.rect(), mTextureFormat, (uchar *)pb.data,
+					pb.rowPitch * Ogre::PixelUtil::getNumElemBytes(pb.format));
+		}
+		
+		mLastUploadedPixels = pb.getWidth() * pb.getHeight();
+		
+		hwBuffer->unlock();
+	}
+	
+	void UiManager::setTileDiffing(bool aEnabled, int aTileSize)
+	{
+		delete mTileDiff;
+		mTileDiff = NULL;
+		
+		if (aEnabled)
+		{
+			mTileDiff = new TileDiff(aTileSize);
+			mTexturePaddingDirty = true;
+		}
+		else if (mTextureFormat == Enums::TextureFormatARGB8888)
+		{
+			mTextureImage = QImage();
+		}
+	}
+	
+	void UiManager::renderChangedTiles(const Ogre::TexturePtr &aTexture)
+	{
+		assert(mTileDiff);
+		
+		// only the render size is shown; the rest of the power of two texture is padding
+		const QSize textureSize(aTexture->getWidth(), aTexture->getHeight());
+		const QRect renderRect = QRect(QPoint(0, 0), getRenderSize(mWindowSize)) & QRect(QPoint(0, 0),
+				textureSize);
+		
+		prepareTextureImage(renderRect.size());
+		rasterize(mTextureImage);
+		
+		const QVector<QRect> changedRects = mTileDiff->update(mTextureImage);
+		
+		// the pixel box spans the whole image; sub volumes keep its row pitch
+		const Ogre::PixelBox imageBox(mTextureImage.width(), mTextureImage.height(), 1,
+				Ogre::PF_A8R8G8B8, mTextureImage.bits());
+		const Ogre::PixelFormat textureFormat = toOgrePixelFormat(mTextureFormat);
+		const int bytesPerPixel = Ogre::PixelUtil::getNumElemBytes(textureFormat);
+		Ogre::HardwarePixelBufferSharedPtr hwBuffer = aTexture->getBuffer(0, 0);
+		
+		mLastUploadedPixels = 0;
+		
+		if (mTexturePaddingDirty)
+		{
+			// the right strip spans the full height, the bottom strip the render width
+			const QRect paddingRects[2] = { QRect(renderRect.width(), 0, textureSize.width()
+					- renderRect.width(), textureSize.height()), QRect(0, renderRect.height(),
+					renderRect.width(), textureSize.height() - renderRect.height()) };
+			
+			for (int i = 0; i < 2; ++i)
+			{
+				const QRect &rect = paddingRects[i];
+				if (rect.isEmpty())
+				{
+					continue;
+				}
+				
+				mConversionBuffer.fill(0, rect.width() * rect.height() * bytesPerPixel);
+				hwBuffer->blitFromMemory(Ogre::PixelBox(rect.width(), rect.height(), 1, textureFormat,
+						mConversionBuffer.data()), Ogre::Box(rect.left(), rect.top(), rect.right() + 1,
+						rect.bottom() + 1));
+				
+				mLastUploadedPixels += rect.width() * rect.height();
+			}
+			
+			mTexturePaddingDirty = false;
+		}
+		
+		foreach(const QRect &rect, changedRects)
+		{
+			const Ogre::Box box(rect.left(), rect.top(), rect.right() + 1, rect.bottom() + 1);
+			
+			if (mTextureFormat == Enums::TextureFormatARGB8888)
+			{
+				hwBuffer->blitFromMemory(imageBox.getSubVolume(box), box);
+			}
+			else
+			{
+				// convert with our kernels; Ogre's generic conversion is much slower
+				mConversionBuffer.resize(rect.width() * rect.height() * bytesPerPixel);
+				convertPixels(mTextureImage, rect, mTextureFormat, (uchar *)mConversionBuffer.data(),
+						rect.width() * bytesPerPixel);
+				hwBuffer->blitFromMemory(Ogre::PixelBox(rect.width(), rect.height(), 1,
+						textureFormat, mConversionBuffer.data()), box);
+			}
+			
+			mLastUploadedPixels += rect.width() * rect.height();
+		}
+	}
+	
+	void UiManager::prepareTextureImage(const QSize &aSize)
+	{
+		if (mTextureImage.size() != aSize)
+		{
+			mTextureImage = QImage(aSize, QImage::Format_ARGB32);
+			
+			if (mTileDiff)
+			{
+				mTileDiff->reset();
+			}
+			mTexturePaddingDirty = true;
+		}
+	}
+	
+	void UiManager::setTextureFormat(Enums::TextureFormat aFormat)
+	{
+		mTextureFormat = aFormat;
+	}
+	
+	void UiManager::setTintColour(const QColor &aColour)
+	{
+		mTintColour = aColour;
+	}
+	
+	void UiManager::setStaticUi(bool aStatic)
+	{
+		mStaticUi = aStatic;
+		
+		if (!mStaticUi)
+		{
+			mStaticEncodeTimer->stop();
+			++mContentGeneration;
+		}
+		
+		// the texture contents have to be rendered again, into mTextureImage or into the texture
+		setUiDirty(true);
+	}
+	
+	void UiManager::encodeStaticUi()
+	{
+		if (!mStaticUi || mHibernating || mTextureImage.isNull() || mTextureFormat
+				!= Enums::TextureFormatARGB8888 || mEncodeWatcher->isRunning())
+		{
+			// a running encode is dropped on completion; try again afterwards
+			if (mStaticUi && mEncodeWatcher->isRunning())
+			{
+				mStaticEncodeTimer->start();
+			}
+			return;
+		}
+		
+		const Ogre::RenderSystemCapabilities *capabilities =
+				Ogre::Root::getSingleton().getRenderSystem()->getCapabilities();
+		if (!capabilities->hasCapability(Ogre::RSC_TEXTURE_COMPRESSION_DXT))
+		{
+			return;
+		}
+		
+		Ogre::TexturePtr texture = Ogre::TextureManager::getSingleton().getByName(mTextureName);
+		if (texture.isNull())
+		{
+			return;
+		}
+		
+		// only the render size is shown; the padding of the power of two texture stays transparent
+		const QSize textureSize(texture->getWidth(), texture->getHeight());
+		const QRect renderRect = QRect(QPoint(0, 0), getRenderSize(mWindowSize)) & mTextureImage.rect();
+		const QImage renderImage = renderRect == mTextureImage.rect() ? mTextureImage
+				: mTextureImage.copy(renderRect);
+		
+		// the worker gets an implicitly shared copy; the next render detaches mTextureImage
+		mEncodeGeneration = mContentGeneration;
+		mEncodeWatcher->setFuture(QtConcurrent::run(Utility::compressImage, renderImage, textureSize));
+	}
+	
+	void UiManager::staticUiEncoded()
+	{
+		const Utility::CompressedImage compressed = mEncodeWatcher->result();
+		
+		// drop results for outdated contents
+		if (mEncodeGeneration != mContentGeneration || !mStaticUi || mHibernating
+				|| compressed.format == Ogre::PF_UNKNOWN || mMaterial.isNull())
+		{
+			return;
+		}
+		
+		removeCompressedTexture();
+		
+		const std::string compressedName = mTextureName + Constants::UI_COMPRESSED_TEXTURE_SUFFIX;
+		Ogre::TexturePtr compressedTexture = Ogre::TextureManager::getSingleton().createManual(
+				compressedName, "General", Ogre::TEX_TYPE_2D, compressed.size.width(),
+				compressed.size.height(), 0, compressed.format, Ogre::TU_STATIC_WRITE_ONLY);
+		compressedTexture->getBuffer(0, 0)->blitFromMemory(Ogre::PixelBox(compressed.size.width(),
+				compressed.size.height(), 1, compressed.format,
+				const_cast<char *> (compressed.data.constData())));
+		
+		// texture scale and scroll of the unit stay the same, both textures have the same size
+		mMaterial->getTechnique(0)->getPass(0)->getTextureUnitState(0)->setTextureName(compressedName);
+		mCompressedTextureShown = true;
+		
+		// release the uncompressed copy while the compressed one is shown
+		Ogre::TexturePtr texture = Ogre::TextureManager::getSingleton().getByName(mTextureName);
+		if (!texture.isNull())
+		{
+			texture->freeInternalResources();
+		}
+	}
+	
+	void UiManager::showUncompressedTexture(const Ogre::TexturePtr &aTexture)
+	{
+		if (!mCompressedTextureShown)
+		{
+			return;
+		}
+		
+		aTexture->createInternalResources();
+		mMaterial->getTechnique(0)->getPass(0)->getTextureUnitState(0)->setTextureName(aTexture->getName());
+		mCompressedTextureShown = false;
+		
+		// the recreated texture has undefined contents
+		if (mTileDiff)
+		{
+			mTileDiff->reset();
+		}
+		mTexturePaddingDirty = true;
+		
+		removeCompressedTexture();
+	}
+	
+	void UiManager::removeCompressedTexture()
+	{
+		if (mTextureName.empty())
+		{
+			return;
+		}
+		
+		if (mCompressedTextureShown && !mMaterial.isNull())
+		{
+			mMaterial->getTechnique(0)->getPass(0)->getTextureUnitState(0)->setTextureName(mTextureName);
+			mCompressedTextureShown = false;
+		}
+		
+		Ogre::TextureManager::getSingleton().remove(mTextureName + Constants::UI_COMPRESSED_TEXTURE_SUFFIX);
+	}
+	
+	void UiManager::setParallelRendering(bool aEnabled)
+	{
+		mParallelRendering = aEnabled;
+	}
+	
+	void UiManager::setThreadSafePainting(QGraphicsItem *aItem, bool aThreadSafe)
+	{
+		assert(aItem);
+		
+		aItem->setData(Constants::UI_THREAD_SAFE_PAINT_DATA_KEY, aThreadSafe);
+	}
+	
+	void UiManager::setLateLatching(Ogre::SceneManager *aSceneManager, const Ogre::TexturePtr &aTexture)
+	{
+		if (mLateLatchSceneManager)
+		{
+			mLateLatchSceneManager->removeRenderQueueListener(this);
+			Ogre::Root::getSingleton().removeFrameListener(this);
+		}
+		
+		mLateLatchSceneManager = aSceneManager;
+		mLateLatchTexture = aSceneManager ? aTexture : Ogre::TexturePtr();
+		
+		if (mLateLatchSceneManager)
+		{
+			assert(!aTexture.isNull());
+			
+			mLateLatchSceneManager->addRenderQueueListener(this);
+			Ogre::Root::getSingleton().addFrameListener(this);
+		}
+	}
+	
+	void UiManager::renderQueueStarted(Ogre::uint8 aQueueGroupId, const Ogre::String &aInvocation,
+			bool &aSkipThisInvocation)
+	{
+		if (aQueueGroupId == Ogre::RENDER_QUEUE_OVERLAY)
+		{
+			latchTexture();
+		}
+	}
+	
+	void UiManager::renderQueueEnded(Ogre::uint8 aQueueGroupId, const Ogre::String &aInvocation,
+			bool &aRepeatThisInvocation)
+	{
+	}
+	
+	bool UiManager::frameEnded(const Ogre::FrameEvent &aEvent)
+	{
+		// the overlay group is only rendered if it contains anything; shown next frame
+		latchTexture();
+		return true;
+	}
+	
+	void UiManager::latchTexture()
+	{
+		// a no-op for all but the first invocation in a frame
+		if (!isRepaintDue() || mHibernating || mLateLatchTexture.isNull() || !isViewSizeMatching(
+				mLateLatchTexture))
+		{
+			return;
+		}
+		
+		renderIntoTexture(mLateLatchTexture);
+		setUiDirty(false);
+	}
+	
+	void UiManager::setFrameClock(bool aEnabled)
+	{
+#if QT_VERSION >= 0x040800
+		if (aEnabled == isFrameClock())
+		{
+			return;
+		}
+		
+		if (aEnabled)
+		{
+			mAnimationDriver = new FrameAnimationDriver(this);
+			mAnimationDriver->install();
+		}
+		else
+		{
+			// deleting an installed driver restores Qt's own timer
+			delete mAnimationDriver;
+			mAnimationDriver = NULL;
+		}
+#else
+		Q_UNUSED(aEnabled);
+#endif
+	}
+	
+	bool UiManager::isFrameClock() const
+	{
+		return (mAnimationDriver != NULL);
+	}
+	
+	void UiManager::advanceFrame(qint64 aFrameTime)
+	{
+		mFrameTime = aFrameTime;
+		
+#if QT_VERSION >= 0x040800
+		// steps in between repaints would only be coalesced anyway
+		if (mAnimationDriver && (mMaxRepaintRate <= 0 || mLastRepaintTime < 0 || mFrameTime
+				- mLastRepaintTime >= 1000 / mMaxRepaintRate))
+		{
+			if (mAnimationDriver->isRunning())
+			{
+				mAnimationDriver->advance();
+			}
+			
+			// scene changes and update requests are posted; mark the UI dirty in this frame
+			QCoreApplication::sendPostedEvents();
+		}
+#endif
+	}
+	
+	void UiManager::setMaxRepaintRate(int aRate)
+	{
+		mMaxRepaintRate = qMax(0, aRate);
+	}
+	
+	bool UiManager::isRepaintDue() const
+	{
+		if (!mUiDirty)
+		{
+			return false;
+		}
+		
+		return (mMaxRepaintRate <= 0 || mLastRepaintTime < 0 || mFrameTime - mLastRepaintTime
+				>= 1000 / mMaxRepaintRate);
+	}
+	
+	bool UiManager::isAnimating() const
+	{
+#if QT_VERSION >= 0x040800
+		return (mAnimationDriver && mAnimationDriver->isRunning());
+#else
+		return false;
+#endif
+	}
+	
+	int UiManager::applyCommands()
+	{
+		return mCommandQueue.apply();
+	}
+	
+	void UiManager::renderIntoImage(QImage &aImage)
+	{
+		rasterize(aImage);
+	}
+	
+	void UiManager::prewarmWidget(QWidget *aWidget)
+	{
+		assert(aWidget && !mRemoteUi);
+		
+		QTime time;
+		time.start();
+		
+		// lay it out as it will be shown
+		if (!mWindowSize.isEmpty())
+		{
+			aWidget->resize(getLayoutSize(mWindowSize));
+		}
+		
+		// glyphs are cached per transformation, so paint at the scale the UI is rendered at
+		QImage image(QSize(qMax(1, qRound(aWidget->width() * mRenderScale)), qMax(1, qRound(
+				aWidget->height() * mRenderScale))), QImage::Format_ARGB32);
+		image.fill(0);
+		
+		QPainter painter(&image);
+		painter.scale(mRenderScale, mRenderScale);
+		
+		QWidget::RenderFlags flags = QWidget::DrawChildren;
+		if (!aWidget->testAttribute(Qt::WA_TranslucentBackground))
+		{
+			flags |= QWidget::DrawWindowBackground;
+		}
+		
+		aWidget->render(&painter, QPoint(0, 0), QRegion(), flags);
+		
+		++mPrewarmedWidgets;
+		mPrewarmTime += time.elapsed();
+	}
+	
+	void UiManager::prewarmText(const QFont &aFont, const QString &aCharacters)
+	{
+		if (aCharacters.isEmpty())
+		{
+			return;
+		}
+		
+		QTime time;
+		time.start();
+		
+		const QFontMetrics metrics(aFont);
+		const QSize textSize(metrics.width(aCharacters), metrics.height());
+		
+		// glyphs outside the image might be skipped, so it holds the whole line
+		QImage image(QSize(qMax(1, qRound(textSize.width() * mRenderScale)), qMax(1, qRound(
+				textSize.height() * mRenderScale))), QImage::Format_ARGB32);
+		image.fill(0);
+		
+		QPainter painter(&image);
+		painter.scale(mRenderScale, mRenderScale);
+		painter.setFont(aFont);
+		painter.setPen(Qt::white);
+		painter.drawText(0, metrics.ascent(), aCharacters);
+		
+		mPrewarmedCharacters += aCharacters.size();
+		mPrewarmedFonts.insert(aFont.key());
+		mPrewarmTime += time.elapsed();
+	}
+	
+	void UiManager::logPrewarmStatistics() const
+	{
+		// Qt 4 has no public API for the current size of its glyph and pixmap caches
+		Ogre::LogManager::getSingleton().logMessage(QString("UI caches prewarmed in %1 ms: %2 "
+				"widgets, %3 characters in %4 fonts, pixmap cache limit %5 KB.").arg(mPrewarmTime).arg(
+				mPrewarmedWidgets).arg(mPrewarmedCharacters).arg(mPrewarmedFonts.size()).arg(
+				QPixmapCache::cacheLimit()).toStdString());
+	}
+	
+	void UiManager::rasterize(QImage &aTarget)
+	{
+		mLastRenderBandCount = 1;
+		
+		// a remote UI has no local widget, so it leaves aTarget empty
+		if (mBackend != Enums::UiBackendGraphicsView)
+		{
+			aTarget.fill(0);
+			
+			if (!mTopLevelWidget)
+			{
+				return;
+			}
+			
+			QPainter painter(&aTarget);
+			
+			// scale the laid out UI to the render size, like the view transform does
+			const QSize layoutSize = getLayoutSize(mWindowSize);
+			const QSize renderSize = getRenderSize(mWindowSize);
+			if (!layoutSize.isEmpty())
+			{
+				painter.scale(qreal(renderSize.width()) / layoutSize.width(), qreal(
+						renderSize.height()) / layoutSize.height());
+			}
+			
+			QWidget::RenderFlags flags = QWidget::DrawChildren;
+			if (!mTopLevelWidget->testAttribute(Qt::WA_TranslucentBackground))
+			{
+				flags |= QWidget::DrawWindowBackground;
+			}
+			
+			mTopLevelWidget->render(&painter, QPoint(0, 0), QRegion(), flags);
+			return;
+		}
+		
+		if (mParallelRendering && rasterizeParallel(aTarget))
+		{
+			return;
+		}
+		
+		aTarget.fill(0);
+		
+		QPainter painter(&aTarget);
+		mWidgetView->render(&painter, QRect(QPoint(0, 0), mWidgetView->size()), QRect(QPoint(0, 0), mWidgetView->size()));
+	}
+	
+	bool UiManager::rasterizeParallel(QImage &aTarget)
+	{
+		const int bandCount = qMin(QThreadPool::globalInstance()->maxThreadCount(),
+				aTarget.height() / Constants::UI_MIN_RENDER_BAND_HEIGHT);
+		
+		if (bandCount < 2)
+		{
+			return false;
+		}
+		
+		// backgrounds and foregrounds are drawn by the view, not by items
+		if (mWidgetScene->backgroundBrush().style() != Qt::NoBrush
+				|| mWidgetScene->foregroundBrush().style() != Qt::NoBrush
+				|| mWidgetView->backgroundBrush().style() != Qt::NoBrush
+				|| mWidgetView->foregroundBrush().style() != Qt::NoBrush)
+		{
+			return false;
+		}
+		
+		// Query everything from the scene on this thread; the workers only 
+		// call paint() on the items.
+		const QTransform viewTransform = mWidgetView->viewportTransform();
+		const QRectF visibleSceneRect = mWidgetView->mapToScene(QRect(QPoint(0, 0), aTarget.size())).boundingRect();
+		
+		QVector<PaintSegment> segments;
+		bool anyThreadSafe = false;
+		
+		foreach(QGraphicsItem *item, mWidgetScene->items(visibleSceneRect, Qt::IntersectsItemBoundingRect, Qt::AscendingOrder))
+		{
+			if (!item->isVisible() || item->effectiveOpacity() <= 0)
+			{
+				continue;
+			}
+			
+			if (item->graphicsEffect() || (item->flags() & QGraphicsItem::ItemClipsToShape))
+			{
+				return false;
+			}
+			
+			for (QGraphicsItem *parent = item->parentItem(); parent; parent = parent->parentItem())
+			{
+				if (parent->flags() & QGraphicsItem::ItemClipsChildrenToShape)
+				{
+					return false;
+				}
+			}
+			
+			// QWidgets can only be painted on the GUI thread
+			const bool threadSafe = item->data(Constants::UI_THREAD_SAFE_PAINT_DATA_KEY).toBool()
+					&& !qgraphicsitem_cast<QGraphicsProxyWidget *>(item);
+			
+			ItemPaintJob job;
+			job.item = item;
+			job.transform = item->deviceTransform(viewTransform);
+			job.inverseTransform = job.transform.inverted();
+			job.opacity = item->effectiveOpacity();
+			job.selected = item->isSelected();
+			job.boundingRect = item->boundingRect();
+			job.viewBounds = job.transform.mapRect(job.boundingRect).toAlignedRect();
+			
+			if (segments.isEmpty() || segments.last().threadSafe != threadSafe)
+			{
+				segments.append(PaintSegment());
+				segments.last().threadSafe = threadSafe;
+			}
+			
+			segments.last().jobs.append(job);
+			anyThreadSafe |= threadSafe;
+		}
+		
+		// without work for the workers, QGraphicsView::render() is just as fast
+		if (!anyThreadSafe)
+		{
+			return false;
+		}
+		
+		aTarget.fill(0);
+		
+		// scanLine() may detach, so the band pointers are taken on this thread
+		QVector<RenderBand> bands(bandCount);
+		
+		for (int i = 0; i < bandCount; ++i)
+		{
+			RenderBand &band = bands[i];
+			band.top = i * aTarget.height() / bandCount;
+			band.width = aTarget.width();
+			band.height = (i + 1) * aTarget.height() / bandCount - band.top;
+			band.bits = aTarget.scanLine(band.top);
+			band.bytesPerLine = aTarget.bytesPerLine();
+			band.format = aTarget.format();
+			band.renderHints = mWidgetView->renderHints();
+		}
+		
+		// Segments are painted in stacking order within each band. While this 
+		// thread paints a GUI thread segment into one band, the workers go on 
+		// with the thread-safe segments of the other bands.
+		QVector<QFuture<void> > pendingBands(bandCount);
+		
+		for (int s = 0; s < segments.size(); ++s)
+		{
+			const PaintSegment &segment = segments.at(s);
+			
+			for (int i = 0; i < bandCount; ++i)
+			{
+				if (segment.threadSafe)
+				{
+					pendingBands[i] = QtConcurrent::run(paintBand, bands.at(i), &segment.jobs);
+				}
+				else
+				{
+					pendingBands[i].waitForFinished();
+					paintBand(bands.at(i), &segment.jobs);
+				}
+			}
+		}
+		
+		for (int i = 0; i < bandCount; ++i)
+		{
+			pendingBands[i].waitForFinished();
+		}
+		
+		mLastRenderBandCount = bandCount;
+		return true;
 	}
 }